@@ -3,6 +3,8 @@
 #include "core/Application.h"
 #include "core/Logger.h"
 #include "core/Asserts.h"
+#include "core/JobSystem.h"
+#include "core/FrameArena.h"
 
 #include "core/InputCodes.h"
 #include "core/Input.h"
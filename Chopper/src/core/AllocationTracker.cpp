@@ -0,0 +1,403 @@
+#include "AllocationTracker.h"
+
+#ifdef CHOPPER_ALLOCATION_TRACKING_ENABLED
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#include <malloc.h>
+// Before Asserts.h, which defines a DebugBreak macro
+#ifdef CHOPPER_WINDOWS_PLATFORM
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <Windows.h>
+#else
+	#include <execinfo.h>
+#endif
+
+#include "Logger.h"
+#include "Asserts.h"
+
+namespace Chopper {
+
+	static constexpr uint32_t s_MaxStackFrames = 16;
+	static constexpr uint32_t s_StackSampleCapacity = 64;
+	static constexpr uint32_t s_MaxLoggedViolations = 32;
+
+	struct ThreadAllocationCounters {
+		// Written by the owning thread only
+		std::atomic<uint64_t> Allocations{ 0 };
+		std::atomic<uint64_t> AllocatedBytes{ 0 };
+		std::atomic<uint64_t> Frees{ 0 };
+		std::atomic<uint64_t> FreedBytes{ 0 };
+		uint32_t ThreadIndex = 0;
+	};
+
+	// Trivial on purpose, touching it from operator new must not run any initialization
+	struct ThreadAllocationState {
+		ThreadAllocationCounters* Counters;
+		const char* GuardName;
+		uint32_t GuardDepth;
+		uint32_t SuspendDepth;
+		// Set while the tracker itself allocates, such allocations are only counted
+		bool Reentrant;
+	};
+
+	static thread_local ThreadAllocationState t_State;
+
+	struct StackSample {
+		uint64_t Size;
+		uint32_t ThreadIndex;
+		uint32_t FrameCount;
+		void* Frames[s_MaxStackFrames];
+	};
+
+	static std::atomic<uint64_t> s_Allocations{ 0 };
+	static std::atomic<uint64_t> s_AllocatedBytes{ 0 };
+	static std::atomic<uint64_t> s_Frees{ 0 };
+	static std::atomic<uint64_t> s_FreedBytes{ 0 };
+
+	static std::atomic<uint32_t> s_StackSampleRate{ 1024 };
+	static std::mutex s_StackSampleMutex;
+	static StackSample s_StackSamples[s_StackSampleCapacity];
+	static uint32_t s_StackSampleCount = 0;
+
+	static std::atomic<AllocationGuardPolicy> s_GuardPolicy{ AllocationGuardPolicy::Log };
+	static std::atomic<uint64_t> s_GuardStartFrame{ 120 };
+	static std::atomic<uint64_t> s_CurrentFrame{ 0 };
+	static std::atomic<uint64_t> s_GuardViolations{ 0 };
+
+	static std::mutex s_FrameMutex;
+	static AllocationCounters s_FrameStart{};
+	static AllocationCounters s_LastFrame{};
+
+	// Never freed, threads may still allocate while static destructors run
+	static std::mutex s_ThreadMutex;
+	static std::vector<ThreadAllocationCounters*>* s_Threads = nullptr;
+
+	static void RegisterThread(ThreadAllocationState& state) {
+		state.Reentrant = true;
+		auto* counters = new ThreadAllocationCounters();
+		{
+			std::lock_guard<std::mutex> lock(s_ThreadMutex);
+			if (!s_Threads)
+				s_Threads = new std::vector<ThreadAllocationCounters*>();
+			counters->ThreadIndex = static_cast<uint32_t>(s_Threads->size());
+			s_Threads->push_back(counters);
+		}
+		state.Counters = counters;
+		state.Reentrant = false;
+	}
+
+	static uint32_t CaptureStack(void** frames) {
+#ifdef CHOPPER_WINDOWS_PLATFORM
+		return CaptureStackBackTrace(2, s_MaxStackFrames, frames, nullptr);
+#else
+		return static_cast<uint32_t>(backtrace(frames, s_MaxStackFrames));
+#endif
+	}
+
+	static void LogStack(void* const* frames, uint32_t frameCount) {
+#ifdef CHOPPER_WINDOWS_PLATFORM
+		for (uint32_t i = 0; i < frameCount; ++i)
+			CHOPPER_LOG_INFO("    #{} {}", i, frames[i]);
+#else
+		char** symbols = backtrace_symbols(frames, static_cast<int>(frameCount));
+		for (uint32_t i = 0; i < frameCount; ++i)
+			CHOPPER_LOG_INFO("    #{} {}", i, symbols ? symbols[i] : "?");
+		std::free(symbols);
+#endif
+	}
+
+	static void SampleStack(ThreadAllocationState& state, uint64_t size) {
+		std::unique_lock<std::mutex> lock(s_StackSampleMutex, std::try_to_lock);
+		if (!lock.owns_lock())
+			return;
+
+		StackSample& sample = s_StackSamples[s_StackSampleCount++ % s_StackSampleCapacity];
+		sample.Size = size;
+		sample.ThreadIndex = state.Counters->ThreadIndex;
+		sample.FrameCount = CaptureStack(sample.Frames);
+	}
+
+	static void ReportGuardViolation(ThreadAllocationState& state, uint64_t size) {
+		uint64_t violation = s_GuardViolations.fetch_add(1, std::memory_order_relaxed);
+		AllocationGuardPolicy policy = s_GuardPolicy.load(std::memory_order_relaxed);
+		if (policy == AllocationGuardPolicy::Count)
+			return;
+
+		if (violation < s_MaxLoggedViolations || policy == AllocationGuardPolicy::Break) {
+			void* frames[s_MaxStackFrames];
+			uint32_t frameCount = CaptureStack(frames);
+			CHOPPER_LOG_ERROR("Allocation of {} bytes inside no-allocation scope \"{}\", frame {}.",
+				size, state.GuardName, s_CurrentFrame.load(std::memory_order_relaxed));
+			LogStack(frames, frameCount);
+			if (violation + 1 == s_MaxLoggedViolations)
+				CHOPPER_LOG_WARN("Further no-allocation scope violations are only counted.");
+		}
+
+		CHOPPER_ASSERT(policy != AllocationGuardPolicy::Break, "Allocation inside a no-allocation scope.");
+	}
+
+	static void OnAllocation(size_t size) {
+		s_Allocations.fetch_add(1, std::memory_order_relaxed);
+		s_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+		ThreadAllocationState& state = t_State;
+		if (!state.Counters) {
+			if (state.Reentrant)
+				return;
+			RegisterThread(state);
+		}
+
+		ThreadAllocationCounters& counters = *state.Counters;
+		uint64_t index = counters.Allocations.load(std::memory_order_relaxed);
+		counters.Allocations.store(index + 1, std::memory_order_relaxed);
+		counters.AllocatedBytes.store(counters.AllocatedBytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+
+		if (state.Reentrant)
+			return;
+		state.Reentrant = true;
+
+		if (state.GuardDepth && !state.SuspendDepth && s_CurrentFrame.load(std::memory_order_relaxed) >= s_GuardStartFrame.load(std::memory_order_relaxed))
+			ReportGuardViolation(state, size);
+
+		uint32_t rate = s_StackSampleRate.load(std::memory_order_relaxed);
+		if (rate && index % rate == 0)
+			SampleStack(state, size);
+
+		state.Reentrant = false;
+	}
+
+	static void OnFree(size_t size) {
+		s_Frees.fetch_add(1, std::memory_order_relaxed);
+		s_FreedBytes.fetch_add(size, std::memory_order_relaxed);
+
+		if (ThreadAllocationCounters* counters = t_State.Counters) {
+			counters->Frees.store(counters->Frees.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			counters->FreedBytes.store(counters->FreedBytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+		}
+	}
+
+	// Usable sizes on both sides, the block size is not known when freeing
+	static void* TrackedAllocate(size_t size, bool nothrow) {
+		for (;;) {
+			if (void* memory = std::malloc(size ? size : 1)) {
+#ifdef CHOPPER_WINDOWS_PLATFORM
+				OnAllocation(_msize(memory));
+#else
+				OnAllocation(malloc_usable_size(memory));
+#endif
+				return memory;
+			}
+
+			std::new_handler handler = std::get_new_handler();
+			if (!handler) {
+				if (nothrow)
+					return nullptr;
+				throw std::bad_alloc();
+			}
+			handler();
+		}
+	}
+
+	static void* TrackedAllocateAligned(size_t size, size_t alignment, bool nothrow) {
+		size = size ? size : 1;
+		for (;;) {
+#ifdef CHOPPER_WINDOWS_PLATFORM
+			if (void* memory = _aligned_malloc(size, alignment)) {
+				OnAllocation(_aligned_msize(memory, alignment, 0));
+				return memory;
+			}
+#else
+			void* memory = nullptr;
+			if (posix_memalign(&memory, std::max(alignment, sizeof(void*)), size) == 0) {
+				OnAllocation(malloc_usable_size(memory));
+				return memory;
+			}
+#endif
+
+			std::new_handler handler = std::get_new_handler();
+			if (!handler) {
+				if (nothrow)
+					return nullptr;
+				throw std::bad_alloc();
+			}
+			handler();
+		}
+	}
+
+	static void TrackedFree(void* memory) {
+		if (!memory)
+			return;
+#ifdef CHOPPER_WINDOWS_PLATFORM
+		OnFree(_msize(memory));
+#else
+		OnFree(malloc_usable_size(memory));
+#endif
+		std::free(memory);
+	}
+
+	static void TrackedFreeAligned(void* memory, [[maybe_unused]] size_t alignment) {
+		if (!memory)
+			return;
+#ifdef CHOPPER_WINDOWS_PLATFORM
+		OnFree(_aligned_msize(memory, alignment, 0));
+		_aligned_free(memory);
+#else
+		OnFree(malloc_usable_size(memory));
+		std::free(memory);
+#endif
+	}
+
+	static AllocationCounters LoadTotals() {
+		AllocationCounters counters{};
+		counters.Allocations = s_Allocations.load(std::memory_order_relaxed);
+		counters.AllocatedBytes = s_AllocatedBytes.load(std::memory_order_relaxed);
+		counters.Frees = s_Frees.load(std::memory_order_relaxed);
+		counters.FreedBytes = s_FreedBytes.load(std::memory_order_relaxed);
+		return counters;
+	}
+
+	bool AllocationTracker::IsEnabled() { return true; }
+
+	void AllocationTracker::OnFrameEnd(uint64_t frameIndex) {
+		AllocationCounters totals = LoadTotals();
+		{
+			std::lock_guard<std::mutex> lock(s_FrameMutex);
+			s_LastFrame.Allocations = totals.Allocations - s_FrameStart.Allocations;
+			s_LastFrame.AllocatedBytes = totals.AllocatedBytes - s_FrameStart.AllocatedBytes;
+			s_LastFrame.Frees = totals.Frees - s_FrameStart.Frees;
+			s_LastFrame.FreedBytes = totals.FreedBytes - s_FrameStart.FreedBytes;
+			s_FrameStart = totals;
+		}
+		s_CurrentFrame.store(frameIndex + 1, std::memory_order_relaxed);
+	}
+
+	AllocationCounters AllocationTracker::GetTotalCounters() {
+		return LoadTotals();
+	}
+
+	AllocationCounters AllocationTracker::GetFrameCounters() {
+		std::lock_guard<std::mutex> lock(s_FrameMutex);
+		return s_LastFrame;
+	}
+
+	AllocationCounters AllocationTracker::GetThreadCounters() {
+		AllocationCounters counters{};
+		if (ThreadAllocationCounters* thread = t_State.Counters) {
+			counters.Allocations = thread->Allocations.load(std::memory_order_relaxed);
+			counters.AllocatedBytes = thread->AllocatedBytes.load(std::memory_order_relaxed);
+			counters.Frees = thread->Frees.load(std::memory_order_relaxed);
+			counters.FreedBytes = thread->FreedBytes.load(std::memory_order_relaxed);
+		}
+		return counters;
+	}
+
+	void AllocationTracker::SetStackSampleRate(uint32_t rate) {
+		s_StackSampleRate.store(rate, std::memory_order_relaxed);
+	}
+
+	void AllocationTracker::SetGuardPolicy(AllocationGuardPolicy policy) {
+		s_GuardPolicy.store(policy, std::memory_order_relaxed);
+	}
+
+	void AllocationTracker::SetGuardStartFrame(uint64_t frameIndex) {
+		s_GuardStartFrame.store(frameIndex, std::memory_order_relaxed);
+	}
+
+	uint64_t AllocationTracker::GetGuardViolationCount() {
+		return s_GuardViolations.load(std::memory_order_relaxed);
+	}
+
+	void AllocationTracker::LogReport() {
+		AllocationCounters totals = LoadTotals();
+		CHOPPER_LOG_INFO("Heap: {} allocations ({} bytes), {} frees ({} bytes), {} no-allocation scope violations.",
+			totals.Allocations, totals.AllocatedBytes, totals.Frees, totals.FreedBytes, GetGuardViolationCount());
+
+		{
+			std::lock_guard<std::mutex> lock(s_ThreadMutex);
+			if (s_Threads) {
+				for (const ThreadAllocationCounters* thread : *s_Threads) {
+					CHOPPER_LOG_INFO("  Thread {}: {} allocations ({} bytes), {} frees ({} bytes)", thread->ThreadIndex,
+						thread->Allocations.load(std::memory_order_relaxed), thread->AllocatedBytes.load(std::memory_order_relaxed),
+						thread->Frees.load(std::memory_order_relaxed), thread->FreedBytes.load(std::memory_order_relaxed));
+				}
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(s_StackSampleMutex);
+		uint32_t sampleCount = std::min(s_StackSampleCount, s_StackSampleCapacity);
+		for (uint32_t i = 0; i < sampleCount; ++i) {
+			const StackSample& sample = s_StackSamples[(s_StackSampleCount - sampleCount + i) % s_StackSampleCapacity];
+			CHOPPER_LOG_INFO("  Sampled allocation of {} bytes on thread {}:", sample.Size, sample.ThreadIndex);
+			LogStack(sample.Frames, sample.FrameCount);
+		}
+	}
+
+	void AllocationTracker::PushNoAllocationScope(const char* name) {
+		ThreadAllocationState& state = t_State;
+		if (state.GuardDepth++ == 0)
+			state.GuardName = name;
+	}
+
+	void AllocationTracker::PopNoAllocationScope() {
+		--t_State.GuardDepth;
+	}
+
+	void AllocationTracker::SuspendNoAllocationScopes() {
+		++t_State.SuspendDepth;
+	}
+
+	void AllocationTracker::ResumeNoAllocationScopes() {
+		--t_State.SuspendDepth;
+	}
+
+}
+
+void* operator new(std::size_t size) { return Chopper::TrackedAllocate(size, false); }
+void* operator new[](std::size_t size) { return Chopper::TrackedAllocate(size, false); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Chopper::TrackedAllocate(size, true); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Chopper::TrackedAllocate(size, true); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return Chopper::TrackedAllocateAligned(size, static_cast<size_t>(alignment), false); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return Chopper::TrackedAllocateAligned(size, static_cast<size_t>(alignment), false); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Chopper::TrackedAllocateAligned(size, static_cast<size_t>(alignment), true); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Chopper::TrackedAllocateAligned(size, static_cast<size_t>(alignment), true); }
+
+void operator delete(void* memory) noexcept { Chopper::TrackedFree(memory); }
+void operator delete[](void* memory) noexcept { Chopper::TrackedFree(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { Chopper::TrackedFree(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { Chopper::TrackedFree(memory); }
+void operator delete(void* memory, std::size_t) noexcept { Chopper::TrackedFree(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { Chopper::TrackedFree(memory); }
+void operator delete(void* memory, std::align_val_t alignment) noexcept { Chopper::TrackedFreeAligned(memory, static_cast<size_t>(alignment)); }
+void operator delete[](void* memory, std::align_val_t alignment) noexcept { Chopper::TrackedFreeAligned(memory, static_cast<size_t>(alignment)); }
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept { Chopper::TrackedFreeAligned(memory, static_cast<size_t>(alignment)); }
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept { Chopper::TrackedFreeAligned(memory, static_cast<size_t>(alignment)); }
+void operator delete(void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept { Chopper::TrackedFreeAligned(memory, static_cast<size_t>(alignment)); }
+void operator delete[](void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept { Chopper::TrackedFreeAligned(memory, static_cast<size_t>(alignment)); }
+
+#else
+
+namespace Chopper {
+
+	bool AllocationTracker::IsEnabled() { return false; }
+	void AllocationTracker::OnFrameEnd(uint64_t) {}
+	AllocationCounters AllocationTracker::GetTotalCounters() { return {}; }
+	AllocationCounters AllocationTracker::GetFrameCounters() { return {}; }
+	AllocationCounters AllocationTracker::GetThreadCounters() { return {}; }
+	void AllocationTracker::SetStackSampleRate(uint32_t) {}
+	void AllocationTracker::SetGuardPolicy(AllocationGuardPolicy) {}
+	void AllocationTracker::SetGuardStartFrame(uint64_t) {}
+	uint64_t AllocationTracker::GetGuardViolationCount() { return 0; }
+	void AllocationTracker::LogReport() {}
+	void AllocationTracker::PushNoAllocationScope(const char*) {}
+	void AllocationTracker::PopNoAllocationScope() {}
+	void AllocationTracker::SuspendNoAllocationScopes() {}
+	void AllocationTracker::ResumeNoAllocationScopes() {}
+
+}
+
+#endif
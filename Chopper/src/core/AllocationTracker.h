@@ -0,0 +1,87 @@
+#pragma once
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+namespace Chopper {
+
+	struct AllocationCounters {
+		uint64_t Allocations = 0;
+		uint64_t AllocatedBytes = 0;
+		uint64_t Frees = 0;
+		uint64_t FreedBytes = 0;
+	};
+
+	enum class AllocationGuardPolicy {
+		// Only counted
+		Count,
+		// Counted and logged with the call stack, up to a limit
+		Log,
+		// Logged, then the debugger is triggered
+		Break
+	};
+
+	// Replaces the global operator new/delete when built with CHOPPER_TRACK_ALLOCATIONS. Counts
+	// allocations per thread and per frame, samples call stacks and reports allocations made
+	// inside NoAllocationScope guards. Without the option every query returns zeroes.
+	class CHOPPER_API AllocationTracker {
+	public:
+		static bool IsEnabled();
+
+		// Called by the application at the end of every frame
+		static void OnFrameEnd(uint64_t frameIndex);
+
+		static AllocationCounters GetTotalCounters();
+		// All threads, during the last complete frame
+		static AllocationCounters GetFrameCounters();
+		// Calling thread only, since it started
+		static AllocationCounters GetThreadCounters();
+
+		// Captures the call stack of every Nth allocation, 0 disables sampling
+		static void SetStackSampleRate(uint32_t rate);
+
+		static void SetGuardPolicy(AllocationGuardPolicy policy);
+		// Guards stay quiet before this frame, startup and the first frames allocate legitimately
+		static void SetGuardStartFrame(uint64_t frameIndex);
+		static uint64_t GetGuardViolationCount();
+
+		// Per-thread totals, guard violations and the sampled call stacks
+		static void LogReport();
+
+		static void PushNoAllocationScope(const char* name);
+		static void PopNoAllocationScope();
+		// Work that is meant to allocate, such as swapchain recreation or debug UI, runs
+		// suspended. Guards pushed while suspended stay quiet as well.
+		static void SuspendNoAllocationScopes();
+		static void ResumeNoAllocationScopes();
+	};
+
+	class NoAllocationScope {
+	public:
+		NoAllocationScope(const char* name) { AllocationTracker::PushNoAllocationScope(name); }
+		~NoAllocationScope() { AllocationTracker::PopNoAllocationScope(); }
+
+		NoAllocationScope(const NoAllocationScope&) = delete;
+		NoAllocationScope& operator=(const NoAllocationScope&) = delete;
+	};
+
+	class SuspendNoAllocationScope {
+	public:
+		SuspendNoAllocationScope() { AllocationTracker::SuspendNoAllocationScopes(); }
+		~SuspendNoAllocationScope() { AllocationTracker::ResumeNoAllocationScopes(); }
+
+		SuspendNoAllocationScope(const SuspendNoAllocationScope&) = delete;
+		SuspendNoAllocationScope& operator=(const SuspendNoAllocationScope&) = delete;
+	};
+
+}
+
+#ifdef CHOPPER_ALLOCATION_TRACKING_ENABLED
+#define CHOPPER_ALLOCATION_CONCAT_IMPL(a, b) a##b
+#define CHOPPER_ALLOCATION_CONCAT(a, b) CHOPPER_ALLOCATION_CONCAT_IMPL(a, b)
+#define CHOPPER_NO_ALLOCATION_SCOPE(name) ::Chopper::NoAllocationScope CHOPPER_ALLOCATION_CONCAT(noAllocationScope, __LINE__)(name)
+#define CHOPPER_SUSPEND_NO_ALLOCATION_SCOPE() ::Chopper::SuspendNoAllocationScope CHOPPER_ALLOCATION_CONCAT(suspendNoAllocationScope, __LINE__)
+#else
+#define CHOPPER_NO_ALLOCATION_SCOPE(name)
+#define CHOPPER_SUSPEND_NO_ALLOCATION_SCOPE()
+#endif
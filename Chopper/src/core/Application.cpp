@@ -4,6 +4,8 @@
 #include <core/Asserts.h>
 
 #include <core/Input.h>
+#include <core/Profiler.h>
+#include <core/AllocationTracker.h>
 
 #include <renderer/Renderer.h>
 
@@ -18,32 +20,113 @@ namespace Chopper {
 		Window::WindowState state{};
 		state.VulkanAsBackend = true;
 		m_Window = std::make_unique<Window>(state);
-		m_Window->SetEventCallback([&](Event& e) { OnEvent(e); });
+		m_Window->SetEventCallback([&](Event& e) { QueueEvent(e); });
 
 		bool result = Renderer::Init(RENDERER_VULKAN_BACKEND);
 		CHOPPER_ASSERT(result, "Renderer could not be initialized!");
 
 		m_ImGuiLayer = new ImGuiLayer;
 		PushOverlay(m_ImGuiLayer);
+
+		// Toggled with F3, hidden by default outside of debug builds
+		m_PerformanceOverlay = new PerformanceOverlay;
+#ifndef DEBUG_BUILD
+		m_PerformanceOverlay->SetVisible(false);
+#endif
+		PushOverlay(m_PerformanceOverlay);
 	}
 
 	Application::~Application() { }
 
 	void Application::Run() {
-		while (m_Running) {
-			m_Window->OnUpdate();
+		CHOPPER_PROFILE_THREAD("Main Thread");
 
-			if (m_Suspended)
+		while (m_Running) {
+			CHOPPER_PROFILE_FRAME(m_FrameClock.GetFrameIndex());
+			CHOPPER_PROFILE_SCOPE("Frame");
+
+			// Requested during the previous frame, writing it out allocates
+			if (m_FrameStatsDumpRequested) {
+				m_FrameStatsDumpRequested = false;
+				m_FrameStats.LogSummary();
+				m_FrameStats.WriteCsv(m_FrameStatsPath);
+			}
+
+			CHOPPER_NO_ALLOCATION_SCOPE("Frame");
+
+			m_FrameClock.Tick();
+			{
+				CHOPPER_PROFILE_SCOPE("Application::PollEvents");
+				m_Window->OnUpdate();
+				DispatchEvents();
+				DispatchPostedEvents();
+			}
+
+			if (m_Suspended) {
+				m_FrameClock.AddWaitTime(m_FramePacer.Wait());
+				m_FrameClock.EndFrame();
+				AllocationTracker::OnFrameEnd(m_FrameClock.GetFrameIndex() - 1);
 				continue;
+			}
+
+			while (m_FrameClock.ConsumeFixedStep()) {
+				CHOPPER_PROFILE_SCOPE("Application::FixedUpdate");
+				for (Layer* layer : m_LayerStack)
+					layer->OnFixedUpdate(m_FrameClock.GetFixedTimestep());
+			}
+
+			{
+				CHOPPER_PROFILE_SCOPE("Application::Update");
+				float deltaTime = m_FrameClock.GetDeltaTime();
+				for (Layer* layer : m_LayerStack)
+					layer->OnUpdate(deltaTime);
+			}
+
+			{
+				CHOPPER_PROFILE_SCOPE("Application::ImGuiRender");
+				m_ImGuiLayer->Begin();
+				for (Layer* layer : m_LayerStack)
+					layer->OnImGuiRender();
+				m_ImGuiLayer->End();
+			}
+
+			m_FrameClock.AddWaitTime(Renderer::ConsumeWaitTime());
+			{
+				CHOPPER_PROFILE_SCOPE("FramePacer::Wait");
+				m_FrameClock.AddWaitTime(m_FramePacer.Wait());
+			}
+			m_FrameClock.EndFrame();
+			AllocationTracker::OnFrameEnd(m_FrameClock.GetFrameIndex() - 1);
+
+			const RendererFrameStats& rendererStats = Renderer::GetFrameStats();
+			AllocationCounters allocations = AllocationTracker::GetFrameCounters();
+			FrameSample sample{};
+			sample.FrameTime = m_FrameClock.GetFrameTime();
+			sample.CpuTime = m_FrameClock.GetCpuTime();
+			sample.GpuTime = rendererStats.GpuTime;
+			sample.FenceWaitTime = rendererStats.FenceWaitTime;
+			sample.AcquireTime = rendererStats.AcquireTime;
+			sample.PresentTime = rendererStats.PresentTime;
+			sample.Allocations = static_cast<uint32_t>(allocations.Allocations);
+			sample.AllocatedBytes = allocations.AllocatedBytes;
+			m_FrameStats.Push(m_FrameClock.GetFrameIndex() - 1, sample);
+		}
 
-			for (Layer* layer : m_LayerStack)
-				layer->OnUpdate(0);
+		m_FrameStats.LogSummary();
+		AllocationTracker::LogReport();
+		if ((m_DumpFrameStatsOnExit || m_FrameStatsDumpRequested) && !m_FrameStatsPath.empty())
+			m_FrameStats.WriteCsv(m_FrameStatsPath);
+	}
 
-			m_ImGuiLayer->Begin();
-			for (Layer* layer : m_LayerStack)
-				layer->OnImGuiRender();
-			m_ImGuiLayer->End();
-		}
+	void Application::EnableRenderThread(uint32_t framesInFlight) {
+		CHOPPER_ASSERT(m_FrameClock.GetFrameIndex() == 0, "Render thread must be enabled before the first frame!");
+		if (Renderer::IsRenderThreadEnabled())
+			return;
+
+		// ImGui draws platform windows through the graphics queue from the main thread,
+		// which would race with the render thread
+		m_ImGuiLayer->SetViewportsEnabled(false);
+		Renderer::StartRenderThread(framesInFlight);
 	}
 
 	void Application::PushLayer(Layer* layer) {
@@ -56,15 +139,79 @@ namespace Chopper {
 		layer->OnAttach();
 	}
 
+	void Application::QueueEvent(Event& e) {
+		if (m_EventQueue.Push(e))
+			return;
+
+		// Full, keep ordering by flushing what is queued before this event
+		DispatchEvents();
+		m_EventQueue.Push(e);
+	}
+
+	static constexpr uint32_t s_RecordedEventCategories = EventCategoryAll & ~EventCategoryWindow;
+
+	void Application::DispatchEvents() {
+		m_EventQueue.Drain([this](Event& e) {
+			if (e.GetCategory() & s_RecordedEventCategories) {
+				if (IsReplaying())
+					return;
+				if (IsRecording())
+					m_EventRecorder.Record(e, m_FrameClock.GetFrameIndex(), m_FrameClock.GetElapsedTime());
+			}
+			OnEvent(e);
+		});
+
+		if (IsReplaying()) {
+			m_EventReplayer.Replay(m_FrameClock.GetFrameIndex(), [this](Event& e) { OnEvent(e); });
+			if (m_EventReplayer.IsFinished()) {
+				CHOPPER_LOG_INFO("Event replay finished on frame {}.", m_FrameClock.GetFrameIndex());
+				StopReplay();
+			}
+		}
+	}
+
+	bool Application::StartRecording(const std::string& path) {
+		CHOPPER_ASSERT(!IsReplaying(), "Cannot record events while replaying!");
+		return m_EventRecorder.Open(path, m_FrameClock.GetFrameIndex() + 1, m_FrameClock.GetElapsedTime());
+	}
+
+	void Application::StopRecording() {
+		m_EventRecorder.Close();
+	}
+
+	bool Application::StartReplay(const std::string& path) {
+		StopRecording();
+		return m_EventReplayer.Open(path, m_FrameClock.GetFrameIndex() + 1);
+	}
+
+	void Application::StopReplay() {
+		m_EventReplayer.Close();
+	}
+
+	bool Application::PostEvent(const Event& e) {
+		return m_PostedEvents.Push(EventStorage{ e });
+	}
+
+	void Application::DispatchPostedEvents() {
+		EventStorage storage;
+		for (uint32_t i = 0; i < m_PostedEventBudget && m_PostedEvents.Pop(storage); ++i)
+			OnEvent(storage.Get());
+	}
+
 	void Application::OnEvent(Event& e) {
+		CHOPPER_NO_ALLOCATION_SCOPE("Application::OnEvent");
+
 		EventDispatcher dispatcher(e);
-		dispatcher.Dispatch<WindowCloseEvent>([&](WindowCloseEvent& e) { return OnWindowClose(e); });
-		dispatcher.Dispatch<WindowResizeEvent>([&](WindowResizeEvent& e) { return OnWindowResize(e); });
+		dispatcher.DispatchAll(
+			[&](WindowCloseEvent& e) { return OnWindowClose(e); },
+			[&](WindowResizeEvent& e) { return OnWindowResize(e); },
+			[&](KeyPressedEvent& e) { return OnKeyPressed(e); }
+		);
 
-		for (auto it = m_LayerStack.rbegin(); it != m_LayerStack.rend(); ++it) {
+		for (Layer* layer : m_LayerStack.GetSubscribers(e.GetEventType())) {
 			if (e.IsHandled())
 				break;
-			(*it)->OnEvent(e);
+			layer->OnEvent(e);
 		}
 	}
 
@@ -83,4 +230,11 @@ namespace Chopper {
 
 		return false;
 	}
+
+	bool Application::OnKeyPressed(KeyPressedEvent& e) {
+		// Deferred to the start of the next frame, outside the no-allocation scope
+		if (e.GetKeyCode() == Key::F12 && e.GetRepeatCount() == 0 && !m_FrameStatsPath.empty())
+			m_FrameStatsDumpRequested = true;
+		return false;
+	}
 }
@@ -4,11 +4,19 @@
 #include <common/includes.h>
 
 #include "Event.h"
+#include "EventQueue.h"
+#include "MPMCQueue.h"
+#include "EventRecorder.h"
 #include "LayerStack.h"
+#include "FrameClock.h"
+#include "FramePacer.h"
+#include "FrameStats.h"
 #include <platform/Window.h>
 #include <imgui/ImGuiLayer.h>
+#include <imgui/PerformanceOverlay.h>
 
 #include "events/WindowEvent.h"
+#include "events/KeyEvent.h"
 
 namespace Chopper {
 
@@ -22,22 +30,70 @@ namespace Chopper {
 		void PushLayer(Layer* layer);
 		void PushOverlay(Layer* layer);
 
+		// Dispatches immediately, window events are queued and dispatched once per frame instead
 		void OnEvent(Event& e);
 
+		// Safe from any thread. Posted events are dispatched on the main thread at the start of
+		// the next frame, returns false when the queue is full.
+		bool PostEvent(const Event& e);
+		// Maximum posted events dispatched per frame, the rest wait for the following frames
+		inline void SetPostedEventBudget(uint32_t budget) { m_PostedEventBudget = budget; }
+
+		// Keyboard and mouse events are written with the frame they were dispatched on
+		bool StartRecording(const std::string& path);
+		void StopRecording();
+		// Replaces live keyboard and mouse input with a recording, starting on the next frame.
+		// Window events stay live, the replay stops by itself once the recording ends.
+		bool StartReplay(const std::string& path);
+		void StopReplay();
+
+		inline bool IsRecording() const { return m_EventRecorder.IsOpen(); }
+		inline bool IsReplaying() const { return m_EventReplayer.IsOpen(); }
+
+		// Must be called before the first frame, e.g. from the client application constructor
+		void EnableRenderThread(uint32_t framesInFlight = 2);
+
 		inline Window& GetWindow() { return *m_Window; }
+		inline FrameClock& GetFrameClock() { return m_FrameClock; }
+		inline FramePacer& GetFramePacer() { return m_FramePacer; }
+		inline FrameStats& GetFrameStats() { return m_FrameStats; }
+		inline PerformanceOverlay& GetPerformanceOverlay() { return *m_PerformanceOverlay; }
+
+		// The frame statistics CSV is written to path on F12, and on exit when onExit is set
+		inline void SetFrameStatsDump(const std::string& path, bool onExit) { m_FrameStatsPath = path; m_DumpFrameStatsOnExit = onExit; }
 
 		inline static Application& Get() { return *s_Instance; }
 
 	private:
+		void QueueEvent(Event& e);
+		void DispatchEvents();
+		void DispatchPostedEvents();
+
 		bool OnWindowClose(WindowCloseEvent& e);
 		bool OnWindowResize(WindowResizeEvent& e);
+		bool OnKeyPressed(KeyPressedEvent& e);
 
 		std::unique_ptr<Window> m_Window;
 		bool m_Running = true;
 		bool m_Suspended = false;
 
+		EventQueue m_EventQueue;
+		MPMCQueue<EventStorage> m_PostedEvents{ 1024 };
+		uint32_t m_PostedEventBudget = 256;
+
+		EventRecorder m_EventRecorder;
+		EventReplayer m_EventReplayer;
+
+		FrameClock m_FrameClock;
+		FramePacer m_FramePacer;
+		FrameStats m_FrameStats;
+		std::string m_FrameStatsPath = "frame_stats.csv";
+		bool m_DumpFrameStatsOnExit = false;
+		bool m_FrameStatsDumpRequested = false;
+
 		LayerStack m_LayerStack;
 		ImGuiLayer* m_ImGuiLayer;
+		PerformanceOverlay* m_PerformanceOverlay;
 
 		static Application* s_Instance;
 	};
@@ -0,0 +1,154 @@
+#include "AsyncLogger.h"
+
+#include <spdlog/sinks/sink.h>
+
+#include <cstring>
+
+namespace Chopper {
+
+	AsyncLogger::AsyncLogger(std::string name, spdlog::sinks_init_list sinks, uint32_t capacity, LogOverflowPolicy policy)
+		: spdlog::logger(std::move(name), sinks), m_Queue(capacity), m_Policy(policy) {
+		m_Worker = std::thread(&AsyncLogger::WorkerMain, this);
+	}
+
+	AsyncLogger::~AsyncLogger() {
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_Running.store(false, std::memory_order_release);
+		}
+		m_WakeCondition.notify_one();
+		if (m_Worker.joinable())
+			m_Worker.join();
+	}
+
+	AsyncLogStats AsyncLogger::GetStats() const {
+		AsyncLogStats stats;
+		stats.Dropped = m_Dropped.load(std::memory_order_relaxed);
+		stats.Blocked = m_Blocked.load(std::memory_order_relaxed);
+		stats.HeapPayloads = m_HeapPayloads.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	void AsyncLogger::sink_it_(const spdlog::details::log_msg& msg) {
+		Entry entry;
+		entry.Time = msg.time;
+		entry.Source = msg.source;
+		entry.ThreadId = msg.thread_id;
+		entry.Level = msg.level;
+		entry.Flush = false;
+		entry.Size = static_cast<uint32_t>(msg.payload.size());
+		entry.HeapPayload = nullptr;
+
+		if (entry.Size <= s_InlinePayloadSize) {
+			std::memcpy(entry.Payload, msg.payload.data(), entry.Size);
+		}
+		else {
+			entry.HeapPayload = new char[entry.Size];
+			std::memcpy(entry.HeapPayload, msg.payload.data(), entry.Size);
+			m_HeapPayloads.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Enqueue(entry);
+
+		// flush_on() levels, errors right before an assert breaks must reach the sinks first
+		if (should_flush_(msg))
+			flush_();
+	}
+
+	void AsyncLogger::flush_() {
+		Entry entry{};
+		entry.Flush = true;
+		uint64_t ticket = m_FlushRequests.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+		// Flush requests always wait for space, they must not be lost
+		while (!m_Queue.Push(entry))
+			std::this_thread::yield();
+		m_WakeCondition.notify_one();
+
+		// Every flush request is pushed after taking its ticket, so once `ticket` requests are done
+		// one of them was queued after everything this thread logged before calling flush
+		while (m_FlushesDone.load(std::memory_order_acquire) < ticket)
+			std::this_thread::yield();
+	}
+
+	void AsyncLogger::Enqueue(const Entry& entry) {
+		if (m_Queue.Push(entry))
+			return;
+
+		switch (m_Policy) {
+			case LogOverflowPolicy::Block: {
+				m_Blocked.fetch_add(1, std::memory_order_relaxed);
+				m_WakeCondition.notify_one();
+				while (!m_Queue.Push(entry))
+					std::this_thread::yield();
+				break;
+			}
+			case LogOverflowPolicy::DropNewest: {
+				Discard(entry);
+				break;
+			}
+			case LogOverflowPolicy::DropOldest: {
+				Entry oldest;
+				while (!m_Queue.Push(entry)) {
+					if (m_Queue.Pop(oldest))
+						Discard(oldest);
+				}
+				break;
+			}
+		}
+	}
+
+	void AsyncLogger::Discard(const Entry& entry) {
+		if (entry.Flush) {
+			// Nothing can be written from here, release the waiter instead of deadlocking it
+			m_FlushesDone.fetch_add(1, std::memory_order_acq_rel);
+			return;
+		}
+
+		delete[] entry.HeapPayload;
+		m_Dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void AsyncLogger::Process(const Entry& entry) {
+		if (entry.Flush) {
+			for (auto& sink : sinks_)
+				sink->flush();
+			m_FlushesDone.fetch_add(1, std::memory_order_acq_rel);
+			return;
+		}
+
+		const char* payload = entry.HeapPayload ? entry.HeapPayload : entry.Payload;
+		spdlog::details::log_msg msg(entry.Time, entry.Source, name_, entry.Level, spdlog::string_view_t(payload, entry.Size));
+		msg.thread_id = entry.ThreadId;
+
+		for (auto& sink : sinks_) {
+			if (sink->should_log(msg.level))
+				sink->log(msg);
+		}
+
+		delete[] entry.HeapPayload;
+	}
+
+	void AsyncLogger::WorkerMain() {
+		Entry entry;
+		for (;;) {
+			while (m_Queue.Pop(entry))
+				Process(entry);
+
+			if (!m_Running.load(std::memory_order_acquire)) {
+				// Producers are gone, whatever is left was queued before shutdown
+				while (m_Queue.Pop(entry))
+					Process(entry);
+				break;
+			}
+
+			// Producers never notify on a plain message, a short sleep bounds the latency instead
+			std::unique_lock<std::mutex> lock(m_WakeMutex);
+			m_WakeCondition.wait_for(lock, std::chrono::milliseconds(2));
+		}
+
+		for (auto& sink : sinks_)
+			sink->flush();
+	}
+
+}
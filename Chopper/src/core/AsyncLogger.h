@@ -0,0 +1,80 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+#include "MPMCQueue.h"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Chopper {
+
+	enum class LogOverflowPolicy {
+		Block,      // Producers wait for free space, nothing is lost
+		DropNewest, // The message being logged is discarded
+		DropOldest  // The oldest queued message is discarded to make room
+	};
+
+	struct AsyncLogStats {
+		uint64_t Dropped = 0;
+		// Pushes that found the queue full under the Block policy
+		uint64_t Blocked = 0;
+		// Messages too long for an entry, their payload went to the heap
+		uint64_t HeapPayloads = 0;
+	};
+
+	// spdlog logger whose sinks run on a background thread. Callers only format the message
+	// and copy it into a preallocated lock-free ring, the worker applies the sink pattern and writes.
+	class CHOPPER_API AsyncLogger : public spdlog::logger {
+	public:
+		AsyncLogger(std::string name, spdlog::sinks_init_list sinks, uint32_t capacity, LogOverflowPolicy policy);
+		~AsyncLogger() override;
+
+		AsyncLogStats GetStats() const;
+
+	protected:
+		void sink_it_(const spdlog::details::log_msg& msg) override;
+		// Blocks until everything logged before has reached the sinks
+		void flush_() override;
+
+	private:
+		static constexpr size_t s_InlinePayloadSize = 192;
+
+		struct Entry {
+			spdlog::log_clock::time_point Time;
+			spdlog::source_loc Source;
+			size_t ThreadId;
+			spdlog::level::level_enum Level;
+			bool Flush;
+			uint32_t Size;
+			char* HeapPayload;
+			char Payload[s_InlinePayloadSize];
+		};
+
+		void Enqueue(const Entry& entry);
+		void Discard(const Entry& entry);
+		void Process(const Entry& entry);
+		void WorkerMain();
+
+		MPMCQueue<Entry> m_Queue;
+		LogOverflowPolicy m_Policy;
+		std::thread m_Worker;
+		std::atomic<bool> m_Running{ true };
+
+		std::mutex m_WakeMutex;
+		std::condition_variable m_WakeCondition;
+
+		std::atomic<uint64_t> m_FlushRequests{ 0 };
+		std::atomic<uint64_t> m_FlushesDone{ 0 };
+
+		std::atomic<uint64_t> m_Dropped{ 0 };
+		std::atomic<uint64_t> m_Blocked{ 0 };
+		std::atomic<uint64_t> m_HeapPayloads{ 0 };
+	};
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+// Shared with the chopper-logdecode tool, keep free of engine dependencies.
+//
+// File layout (native endianness):
+//   header:  "CHBL", uint32 version, uint64 wall clock at start (ns since the Unix epoch)
+//   records: uint8 record kind followed by its body
+//     Format:  uint32 id, uint8 level, uint32 line, uint16 length + file, uint16 length + format string
+//     Message: uint32 format id, uint64 ns since start, uint32 thread, uint32 argument bytes, arguments
+//   arguments: uint8 type tag followed by its value
+//     Int64 / UInt64 / Double: 8 bytes, Bool / Char: 1 byte, String: uint16 length + bytes
+
+namespace Chopper {
+
+	namespace BinaryLogFormat {
+
+		static constexpr char Magic[4] = { 'C', 'H', 'B', 'L' };
+		static constexpr uint32_t Version = 1;
+
+		enum class RecordKind : uint8_t {
+			Format = 1,
+			Message = 2
+		};
+
+		enum class ArgumentType : uint8_t {
+			Int64 = 1,
+			UInt64,
+			Double,
+			Bool,
+			Char,
+			String
+		};
+
+		// Matches spdlog::level::level_enum
+		enum class Level : uint8_t {
+			Trace = 0,
+			Debug,
+			Info,
+			Warn,
+			Error,
+			Critical
+		};
+
+		// Longer string arguments are truncated
+		static constexpr uint32_t MaxStringLength = 4096;
+
+	}
+
+}
@@ -0,0 +1,213 @@
+#include "BinaryLogger.h"
+
+#include "FrameClock.h"
+
+#include <mutex>
+#include <cstdio>
+
+namespace Chopper {
+
+	struct ThreadLogBuffer {
+		// Only contended while Stop or a full buffer writes it out
+		std::mutex Mutex;
+		std::vector<uint8_t> Data;
+		size_t Used = 0;
+		uint32_t ThreadIndex = 0;
+		bool InUse = false;
+	};
+
+	struct FormatInfo {
+		spdlog::level::level_enum Level;
+		const char* Format;
+		const char* File;
+		uint32_t Line;
+	};
+
+	std::atomic<bool> BinaryLogger::s_Active{ false };
+
+	static std::mutex s_FileMutex;
+	static FILE* s_File = nullptr;
+	static uint64_t s_StartTime = 0;
+	static uint32_t s_ThreadBufferSize = 0;
+
+	static std::mutex s_FormatMutex;
+	static std::vector<FormatInfo> s_Formats;
+
+	static std::mutex s_BufferMutex;
+	static std::vector<std::unique_ptr<ThreadLogBuffer>> s_Buffers;
+	static std::atomic<uint32_t> s_NextThreadIndex{ 0 };
+
+	template<typename T>
+	static void WriteValue(FILE* file, const T& value) {
+		std::fwrite(&value, sizeof(T), 1, file);
+	}
+
+	static void WriteString(FILE* file, const char* string) {
+		uint16_t length = static_cast<uint16_t>(std::min<size_t>(std::strlen(string), BinaryLogFormat::MaxStringLength));
+		WriteValue(file, length);
+		std::fwrite(string, 1, length, file);
+	}
+
+	// Expects s_FileMutex to be held
+	static void WriteFormatRecord(uint32_t id, const FormatInfo& info) {
+		WriteValue(s_File, BinaryLogFormat::RecordKind::Format);
+		WriteValue(s_File, id);
+		WriteValue(s_File, static_cast<uint8_t>(info.Level));
+		WriteValue(s_File, info.Line);
+		WriteString(s_File, info.File);
+		WriteString(s_File, info.Format);
+	}
+
+	// Expects the buffer mutex to be held
+	static void WriteOut(ThreadLogBuffer& buffer) {
+		if (buffer.Used == 0)
+			return;
+
+		std::lock_guard<std::mutex> lock(s_FileMutex);
+		if (s_File)
+			std::fwrite(buffer.Data.data(), 1, buffer.Used, s_File);
+		buffer.Used = 0;
+	}
+
+	// Returns the buffer to the pool when its thread exits
+	struct ThreadLogBufferHandle {
+		ThreadLogBuffer* Buffer = nullptr;
+
+		~ThreadLogBufferHandle() {
+			if (!Buffer)
+				return;
+			std::lock_guard<std::mutex> lock(Buffer->Mutex);
+			WriteOut(*Buffer);
+			Buffer->InUse = false;
+		}
+	};
+
+	static thread_local ThreadLogBufferHandle s_ThreadBuffer;
+
+	static ThreadLogBuffer& GetThreadBuffer() {
+		if (s_ThreadBuffer.Buffer)
+			return *s_ThreadBuffer.Buffer;
+
+		std::lock_guard<std::mutex> lock(s_BufferMutex);
+		for (auto& buffer : s_Buffers) {
+			if (!buffer->InUse) {
+				buffer->InUse = true;
+				s_ThreadBuffer.Buffer = buffer.get();
+				break;
+			}
+		}
+
+		if (!s_ThreadBuffer.Buffer) {
+			auto buffer = std::make_unique<ThreadLogBuffer>();
+			buffer->InUse = true;
+			s_ThreadBuffer.Buffer = buffer.get();
+			s_Buffers.emplace_back(std::move(buffer));
+		}
+
+		s_ThreadBuffer.Buffer->ThreadIndex = s_NextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+		return *s_ThreadBuffer.Buffer;
+	}
+
+	bool BinaryLogger::Start(const std::string& path, uint32_t threadBufferSize) {
+		Stop();
+
+		// Same order as RegisterFormat: formats first, then the file
+		std::lock_guard<std::mutex> formatLock(s_FormatMutex);
+		std::lock_guard<std::mutex> lock(s_FileMutex);
+		s_File = std::fopen(path.c_str(), "wb");
+		if (!s_File) {
+			CHOPPER_LOG_ERROR("Could not open binary log file {}.", path);
+			return false;
+		}
+
+		s_StartTime = FrameClock::Now();
+		s_ThreadBufferSize = std::max(threadBufferSize, 4096u);
+
+		uint64_t wallClock = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count());
+		std::fwrite(BinaryLogFormat::Magic, 1, sizeof(BinaryLogFormat::Magic), s_File);
+		WriteValue(s_File, BinaryLogFormat::Version);
+		WriteValue(s_File, wallClock);
+
+		// Call sites registered during an earlier session keep their ids
+		for (uint32_t i = 0; i < s_Formats.size(); ++i)
+			WriteFormatRecord(i, s_Formats[i]);
+
+		s_Active.store(true, std::memory_order_release);
+		CHOPPER_LOG_INFO("Binary logging to {}.", path);
+		return true;
+	}
+
+	void BinaryLogger::Stop() {
+		if (!s_Active.exchange(false, std::memory_order_acq_rel))
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(s_BufferMutex);
+			for (auto& buffer : s_Buffers) {
+				std::lock_guard<std::mutex> bufferLock(buffer->Mutex);
+				WriteOut(*buffer);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(s_FileMutex);
+		std::fclose(s_File);
+		s_File = nullptr;
+		CHOPPER_LOG_INFO("Binary logging stopped.");
+	}
+
+	void BinaryLogger::Flush() {
+		if (!s_ThreadBuffer.Buffer)
+			return;
+
+		std::lock_guard<std::mutex> lock(s_ThreadBuffer.Buffer->Mutex);
+		WriteOut(*s_ThreadBuffer.Buffer);
+	}
+
+	uint32_t BinaryLogger::RegisterFormat(spdlog::level::level_enum level, const char* format, const char* file, uint32_t line) {
+		FormatInfo info{ level, format, file, line };
+
+		std::lock_guard<std::mutex> formatLock(s_FormatMutex);
+		uint32_t id = static_cast<uint32_t>(s_Formats.size());
+		s_Formats.push_back(info);
+
+		// Written before any message using it can reach the file
+		std::lock_guard<std::mutex> fileLock(s_FileMutex);
+		if (s_File)
+			WriteFormatRecord(id, info);
+		return id;
+	}
+
+	uint8_t* BinaryLogger::BeginRecord(uint32_t formatId, uint32_t argumentSize) {
+		ThreadLogBuffer& buffer = GetThreadBuffer();
+		buffer.Mutex.lock();
+
+		uint64_t timestamp = FrameClock::Now() - s_StartTime;
+		size_t recordSize = 1 + sizeof(formatId) + sizeof(timestamp) + sizeof(buffer.ThreadIndex) + sizeof(argumentSize) + argumentSize;
+
+		if (buffer.Used + recordSize > buffer.Data.size()) {
+			WriteOut(buffer);
+			if (buffer.Data.size() < std::max<size_t>(recordSize, s_ThreadBufferSize))
+				buffer.Data.resize(std::max<size_t>(recordSize, s_ThreadBufferSize));
+		}
+
+		uint8_t* out = buffer.Data.data() + buffer.Used;
+		buffer.Used += recordSize;
+
+		*out++ = static_cast<uint8_t>(BinaryLogFormat::RecordKind::Message);
+		std::memcpy(out, &formatId, sizeof(formatId));
+		out += sizeof(formatId);
+		std::memcpy(out, &timestamp, sizeof(timestamp));
+		out += sizeof(timestamp);
+		std::memcpy(out, &buffer.ThreadIndex, sizeof(buffer.ThreadIndex));
+		out += sizeof(buffer.ThreadIndex);
+		std::memcpy(out, &argumentSize, sizeof(argumentSize));
+		out += sizeof(argumentSize);
+		return out;
+	}
+
+	void BinaryLogger::EndRecord() {
+		s_ThreadBuffer.Buffer->Mutex.unlock();
+	}
+
+}
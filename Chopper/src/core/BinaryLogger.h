@@ -0,0 +1,129 @@
+#pragma once
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+#include "Logger.h"
+#include "BinaryLogFormat.h"
+
+#include <atomic>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace Chopper {
+
+	namespace Detail {
+
+		template<typename T>
+		struct BinaryLogArgument {
+			using Type = std::decay_t<T>;
+
+			static constexpr bool IsString = std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>
+				|| std::is_same_v<Type, std::string> || std::is_same_v<Type, std::string_view>;
+			static constexpr bool IsScalar = std::is_arithmetic_v<Type> || std::is_enum_v<Type>;
+			static_assert(IsString || IsScalar, "Binary logging only supports arithmetic, enum and string arguments, use the text logger instead");
+
+			static std::string_view View(const T& value) {
+				std::string_view view{ value };
+				return view.substr(0, BinaryLogFormat::MaxStringLength);
+			}
+
+			static uint32_t Size(const T& value) {
+				if constexpr (IsString)
+					return 1 + sizeof(uint16_t) + static_cast<uint32_t>(View(value).size());
+				else if constexpr (std::is_same_v<Type, bool> || std::is_same_v<Type, char>)
+					return 1 + 1;
+				else
+					return 1 + 8;
+			}
+
+			static void Encode(uint8_t*& out, const T& value) {
+				using Format = BinaryLogFormat::ArgumentType;
+				if constexpr (IsString) {
+					std::string_view view = View(value);
+					uint16_t length = static_cast<uint16_t>(view.size());
+					*out++ = static_cast<uint8_t>(Format::String);
+					std::memcpy(out, &length, sizeof(length));
+					std::memcpy(out + sizeof(length), view.data(), length);
+					out += sizeof(length) + length;
+				}
+				else if constexpr (std::is_same_v<Type, bool> || std::is_same_v<Type, char>) {
+					*out++ = static_cast<uint8_t>(std::is_same_v<Type, bool> ? Format::Bool : Format::Char);
+					*out++ = static_cast<uint8_t>(value);
+				}
+				else {
+					using Value = std::conditional_t<std::is_floating_point_v<Type>, double,
+						std::conditional_t<std::is_enum_v<Type> || std::is_signed_v<Type>, int64_t, uint64_t>>;
+					Value widened = static_cast<Value>(value);
+					*out++ = static_cast<uint8_t>(std::is_floating_point_v<Type> ? Format::Double
+						: std::is_same_v<Value, int64_t> ? Format::Int64 : Format::UInt64);
+					std::memcpy(out, &widened, sizeof(widened));
+					out += sizeof(widened);
+				}
+			}
+		};
+
+	}
+
+	// Deferred-format logging: call sites store a format id and the raw argument bytes into a
+	// per-thread buffer, formatting happens offline with the chopper-logdecode tool.
+	class CHOPPER_API BinaryLogger {
+	public:
+		static bool Start(const std::string& path, uint32_t threadBufferSize = 64 * 1024);
+		// Writes out the buffers of every thread, callers must not be logging meanwhile
+		static void Stop();
+		// Writes out the buffer of the calling thread
+		static void Flush();
+
+		inline static bool IsActive() { return s_Active.load(std::memory_order_relaxed); }
+
+		// Called once per call site, ids stay valid across Start/Stop
+		static uint32_t RegisterFormat(spdlog::level::level_enum level, const char* format, const char* file, uint32_t line);
+
+		template<typename... Args>
+		static void Write(uint32_t formatId, const Args&... args);
+
+	private:
+		// Locks the calling thread buffer and writes the record header, EndRecord unlocks it
+		static uint8_t* BeginRecord(uint32_t formatId, uint32_t argumentSize);
+		static void EndRecord();
+
+		static std::atomic<bool> s_Active;
+	};
+
+	template<typename... Args>
+	void BinaryLogger::Write(uint32_t formatId, const Args&... args) {
+		uint32_t size = (0u + ... + Detail::BinaryLogArgument<Args>::Size(args));
+		uint8_t* out = BeginRecord(formatId, size);
+		(Detail::BinaryLogArgument<Args>::Encode(out, args), ...);
+		EndRecord();
+	}
+
+}
+
+#define CHOPPER_BLOG(level, format, ...) \
+	do { \
+		if (::Chopper::Logger::GetLogger()->should_log(level)) { \
+			if (::Chopper::BinaryLogger::IsActive()) { \
+				static const uint32_t chopperFormatId = ::Chopper::BinaryLogger::RegisterFormat(level, format, __FILE__, __LINE__); \
+				::Chopper::BinaryLogger::Write(chopperFormatId, ##__VA_ARGS__); \
+			} \
+			else { \
+				::Chopper::Logger::GetLogger()->log(level, format, ##__VA_ARGS__); \
+			} \
+		} \
+	} while (0)
+
+#define CHOPPER_BLOG_CRIT(format, ...)  CHOPPER_BLOG(spdlog::level::critical, format, ##__VA_ARGS__)
+#define CHOPPER_BLOG_ERROR(format, ...) CHOPPER_BLOG(spdlog::level::err, format, ##__VA_ARGS__)
+#define CHOPPER_BLOG_WARN(format, ...)  CHOPPER_BLOG(spdlog::level::warn, format, ##__VA_ARGS__)
+#define CHOPPER_BLOG_INFO(format, ...)  CHOPPER_BLOG(spdlog::level::info, format, ##__VA_ARGS__)
+
+#ifdef DEBUG_BUILD
+#define CHOPPER_BLOG_DEBUG(format, ...) CHOPPER_BLOG(spdlog::level::debug, format, ##__VA_ARGS__)
+#define CHOPPER_BLOG_TRACE(format, ...) CHOPPER_BLOG(spdlog::level::trace, format, ##__VA_ARGS__)
+#else
+#define CHOPPER_BLOG_DEBUG(format, ...)
+#define CHOPPER_BLOG_TRACE(format, ...)
+#endif
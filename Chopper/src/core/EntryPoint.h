@@ -6,7 +6,11 @@ extern Chopper::Application* Chopper::CreateApplication();
 
 int main(int argc, char* argv[])
 {
-	Chopper::Logger::Init();
+	Chopper::LoggerSettings loggerSettings{};
+	loggerSettings.Async = true;
+	Chopper::Logger::Init(loggerSettings);
+	Chopper::JobSystem::Init();
+	Chopper::FrameArena::Init();
 	CHOPPER_LOG_CRIT("Tis a message");
 	CHOPPER_LOG_ERROR("Tis a message");
 	CHOPPER_LOG_WARN("Tis a message");
@@ -18,6 +22,9 @@ int main(int argc, char* argv[])
 	app->Run();
 	delete app;
 
+	Chopper::FrameArena::Shutdown();
+	Chopper::JobSystem::Shutdown();
+	Chopper::Logger::Shutdown();
 	return 0;
 }
 
@@ -0,0 +1,22 @@
+#include "Event.h"
+
+#include "events/WindowEvent.h"
+#include "events/KeyEvent.h"
+#include "events/MouseEvent.h"
+
+namespace Chopper {
+
+	std::string Event::GetStateLog() const {
+		switch (m_Type) {
+			case EventType::WindowResize:        return static_cast<const WindowResizeEvent*>(this)->GetStateLog();
+			case EventType::KeyPressed:          return static_cast<const KeyPressedEvent*>(this)->GetStateLog();
+			case EventType::KeyReleased:         return static_cast<const KeyReleasedEvent*>(this)->GetStateLog();
+			case EventType::MouseButtonPressed:
+			case EventType::MouseButtonReleased: return static_cast<const MouseButtonEvent*>(this)->GetStateLog();
+			case EventType::MouseMoved:          return static_cast<const MouseMovedEvent*>(this)->GetStateLog();
+			case EventType::MouseWheel:          return static_cast<const MouseWheelEvent*>(this)->GetStateLog();
+			default:                             return std::string(GetName());
+		}
+	}
+
+}
@@ -3,6 +3,9 @@
 #include <common/definitions.h>
 #include <common/includes.h>
 
+#include <string_view>
+#include <type_traits>
+
 namespace Chopper {
 
 	enum class EventType {
@@ -20,37 +23,128 @@ namespace Chopper {
 		MouseWheel
 	};
 
+	constexpr std::string_view GetEventTypeName(EventType type) {
+		switch (type) {
+			case EventType::WindowClose:         return "WindowClose";
+			case EventType::WindowResize:        return "WindowResize";
+			case EventType::KeyPressed:          return "KeyPressed";
+			case EventType::KeyReleased:         return "KeyReleased";
+			case EventType::MouseButtonPressed:  return "MouseButtonPressed";
+			case EventType::MouseButtonReleased: return "MouseButtonReleased";
+			case EventType::MouseMoved:          return "MouseMoved";
+			case EventType::MouseWheel:          return "MouseWheel";
+			default:                             return "NoEvent";
+		}
+	}
+
+	enum EventCategory : uint32_t {
+		EventCategoryNone        = 0,
+		EventCategoryWindow      = 1u << 0,
+		EventCategoryKeyboard    = 1u << 1,
+		EventCategoryMouseButton = 1u << 2,
+		EventCategoryMouseMove   = 1u << 3,
+		EventCategoryMouseWheel  = 1u << 4,
+
+		EventCategoryAll = EventCategoryWindow | EventCategoryKeyboard | EventCategoryMouseButton | EventCategoryMouseMove | EventCategoryMouseWheel
+	};
+
+	constexpr uint32_t EventCategoryCount = 5;
+
+	constexpr EventCategory GetEventCategory(EventType type) {
+		switch (type) {
+			case EventType::WindowClose:
+			case EventType::WindowResize:        return EventCategoryWindow;
+			case EventType::KeyPressed:
+			case EventType::KeyReleased:         return EventCategoryKeyboard;
+			case EventType::MouseButtonPressed:
+			case EventType::MouseButtonReleased: return EventCategoryMouseButton;
+			case EventType::MouseMoved:          return EventCategoryMouseMove;
+			case EventType::MouseWheel:          return EventCategoryMouseWheel;
+			default:                             return EventCategoryNone;
+		}
+	}
+
+	// Position of the category bit, EventCategoryCount for events without a category
+	constexpr uint32_t GetEventCategoryIndex(EventType type) {
+		uint32_t category = GetEventCategory(type);
+		if (category == EventCategoryNone)
+			return EventCategoryCount;
+
+		uint32_t index = 0;
+		while (!(category & 1u)) {
+			category >>= 1;
+			++index;
+		}
+		return index;
+	}
+
+	// Events are plain trivially-copyable values: no virtual table and no owned memory,
+	// so raising and dispatching one never touches the heap.
 	class CHOPPER_API Event {
 		friend class EventDispatcher;
 	public:
-		Event() = default;
-		Event(std::string name) : m_Name(name) {}
-
-		virtual EventType GetEventType() const = 0;
-		std::string GetName() const { return m_Name; }
-		virtual std::string GetStateLog() const { return GetName(); }
+		inline EventType GetEventType() const { return m_Type; }
+		inline std::string_view GetName() const { return GetEventTypeName(m_Type); }
+		inline EventCategory GetCategory() const { return GetEventCategory(m_Type); }
+		// Formats the event payload, meant for logging only
+		std::string GetStateLog() const;
 
 		const bool IsHandled() { return m_Handled; }
 
 	protected:
-		std::string m_Name;
+		constexpr Event(EventType type) : m_Type(type) {}
+
+		EventType m_Type;
 		bool m_Handled = false;
 	};
 
+	namespace Detail {
+		// Deduces the event type a handler takes from its single parameter
+		template<typename F>
+		struct EventHandlerTraits : EventHandlerTraits<decltype(&F::operator())> {};
+
+		template<typename R, typename A>
+		struct EventHandlerTraits<R(*)(A)> { using Type = std::remove_cv_t<std::remove_reference_t<A>>; };
+
+		template<typename C, typename R, typename A>
+		struct EventHandlerTraits<R(C::*)(A)> : EventHandlerTraits<R(*)(A)> {};
+
+		template<typename C, typename R, typename A>
+		struct EventHandlerTraits<R(C::*)(A) const> : EventHandlerTraits<R(*)(A)> {};
+
+		template<typename F>
+		using HandlerEventType = typename EventHandlerTraits<std::decay_t<F>>::Type;
+	}
+
 	class EventDispatcher {
-		template<typename T>
-		using EventCallback = std::function<bool(T&)>;
 	public:
 		EventDispatcher(Event& e) : m_Event(e) {}
 
-		template <typename T>
-		bool Dispatch(EventCallback<T> func) {
-			if (m_Event.GetEventType() == T::GetStaticType())
-				m_Event.m_Handled = func(*(T*)&m_Event);
+		template<typename T, typename F>
+		bool Dispatch(F&& func) {
+			if (m_Event.m_Type == T::GetStaticType())
+				m_Event.m_Handled = func(static_cast<T&>(m_Event));
+			return m_Event.m_Handled;
+		}
+
+		// Runs every handler whose parameter type matches the event, in order, until one handles it.
+		// The event type is read once and compared against compile-time constants.
+		template<typename... Fs>
+		bool DispatchAll(Fs&&... handlers) {
+			const EventType type = m_Event.m_Type;
+			(TryHandle<Detail::HandlerEventType<Fs>>(type, handlers) || ...);
 			return m_Event.m_Handled;
 		}
 
 	private:
+		template<typename T, typename F>
+		bool TryHandle(EventType type, F& func) {
+			if (type != T::GetStaticType())
+				return false;
+			m_Event.m_Handled = func(static_cast<T&>(m_Event));
+			return m_Event.m_Handled;
+		}
+
 		Event& m_Event;
 	};
 
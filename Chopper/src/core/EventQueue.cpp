@@ -0,0 +1,63 @@
+#include "EventQueue.h"
+
+namespace Chopper {
+
+	static_assert((EventQueue::Capacity & (EventQueue::Capacity - 1)) == 0, "Event queue capacity must be a power of two");
+
+	size_t EventStorage::GetEventSize(EventType type) {
+		switch (type) {
+			case EventType::WindowClose:         return sizeof(WindowCloseEvent);
+			case EventType::WindowResize:        return sizeof(WindowResizeEvent);
+			case EventType::KeyPressed:          return sizeof(KeyPressedEvent);
+			case EventType::KeyReleased:         return sizeof(KeyReleasedEvent);
+			case EventType::MouseButtonPressed:  return sizeof(MouseButtonPressedEvent);
+			case EventType::MouseButtonReleased: return sizeof(MouseButtonReleasedEvent);
+			case EventType::MouseMoved:          return sizeof(MouseMovedEvent);
+			case EventType::MouseWheel:          return sizeof(MouseWheelEvent);
+			default:                             return sizeof(Event);
+		}
+	}
+
+	bool EventQueue::Push(const Event& e) {
+		EventType type = e.GetEventType();
+
+		if (!IsEmpty()) {
+			Slot& last = At(m_Tail - 1);
+			EventType lastType = last.Storage.GetEventType();
+
+			if (!last.Dropped && lastType == type) {
+				if (type == EventType::MouseMoved) {
+					last.Storage.Store(e);
+					++m_CoalescedCount;
+					return true;
+				}
+				if (type == EventType::MouseWheel) {
+					const MouseWheelEvent& wheel = static_cast<const MouseWheelEvent&>(e);
+					MouseWheelEvent& queued = last.Storage.As<MouseWheelEvent>();
+					queued = MouseWheelEvent{ queued.GetXOffset() + wheel.GetXOffset(), queued.GetYOffset() + wheel.GetYOffset() };
+					++m_CoalescedCount;
+					return true;
+				}
+			}
+		}
+
+		if (GetSize() == Capacity)
+			return false;
+
+		if (type == EventType::WindowResize) {
+			for (uint32_t i = m_Head; i != m_Tail; ++i) {
+				Slot& slot = At(i);
+				if (!slot.Dropped && slot.Storage.GetEventType() == EventType::WindowResize) {
+					slot.Dropped = true;
+					++m_CoalescedCount;
+				}
+			}
+		}
+
+		Slot& slot = At(m_Tail++);
+		slot.Storage.Store(e);
+		slot.Dropped = false;
+		return true;
+	}
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+#include "Event.h"
+#include "events/WindowEvent.h"
+#include "events/KeyEvent.h"
+#include "events/MouseEvent.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Chopper {
+
+	// Storage large enough to hold a copy of any event type
+	struct EventStorage {
+		static constexpr size_t Size = std::max({
+			sizeof(WindowCloseEvent), sizeof(WindowResizeEvent),
+			sizeof(KeyPressedEvent), sizeof(KeyReleasedEvent),
+			sizeof(MouseButtonPressedEvent), sizeof(MouseButtonReleasedEvent),
+			sizeof(MouseMovedEvent), sizeof(MouseWheelEvent)
+		});
+		static constexpr size_t Alignment = std::max({
+			alignof(WindowResizeEvent), alignof(KeyPressedEvent),
+			alignof(MouseMovedEvent), alignof(MouseWheelEvent)
+		});
+
+		alignas(Alignment) unsigned char Data[Size];
+
+		EventStorage() = default;
+		EventStorage(const Event& e) { Store(e); }
+
+		void Store(const Event& e) { std::memcpy(Data, &e, GetEventSize(e.GetEventType())); }
+
+		inline Event& Get() { return *reinterpret_cast<Event*>(Data); }
+		inline const Event& Get() const { return *reinterpret_cast<const Event*>(Data); }
+		inline EventType GetEventType() const { return Get().GetEventType(); }
+
+		template<typename T>
+		T& As() { return *reinterpret_cast<T*>(Data); }
+
+		static size_t GetEventSize(EventType type);
+	};
+
+	// Per-frame ring buffer filled by the window callbacks. Consecutive mouse moves merge,
+	// consecutive wheel deltas accumulate and only the last resize of a frame is delivered.
+	class CHOPPER_API EventQueue {
+	public:
+		static constexpr uint32_t Capacity = 256;
+
+		// Returns false when the queue is full, the caller should drain it and retry
+		bool Push(const Event& e);
+
+		// Calls func(Event&) for every queued event in order, events pushed meanwhile are included
+		template<typename F>
+		void Drain(F&& func);
+
+		inline uint32_t GetSize() const { return m_Tail - m_Head; }
+		inline bool IsEmpty() const { return m_Head == m_Tail; }
+		inline uint32_t GetCoalescedCount() const { return m_CoalescedCount; }
+
+	private:
+		struct Slot {
+			EventStorage Storage;
+			bool Dropped;
+		};
+
+		inline Slot& At(uint32_t index) { return m_Slots[index & (Capacity - 1)]; }
+
+		Slot m_Slots[Capacity];
+		uint32_t m_Head = 0;
+		uint32_t m_Tail = 0;
+		uint32_t m_CoalescedCount = 0;
+	};
+
+	template<typename F>
+	void EventQueue::Drain(F&& func) {
+		while (m_Head != m_Tail) {
+			Slot& slot = At(m_Head++);
+			if (slot.Dropped)
+				continue;
+
+			// Copied out so the slot can be reused if the callback raises new events
+			EventStorage storage = slot.Storage;
+			func(storage.Get());
+		}
+		m_CoalescedCount = 0;
+	}
+
+}
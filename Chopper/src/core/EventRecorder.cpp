@@ -0,0 +1,209 @@
+#include "EventRecorder.h"
+
+#include "Logger.h"
+
+#include <cstring>
+
+namespace Chopper {
+
+	template<typename T>
+	static void WriteValue(std::ofstream& file, const T& value) {
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template<typename T>
+	static bool ReadValue(const std::vector<uint8_t>& data, size_t& offset, T& value) {
+		if (offset + sizeof(T) > data.size())
+			return false;
+		std::memcpy(&value, data.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+
+	bool EventRecorder::Open(const std::string& path, uint64_t frameIndex, float time) {
+		Close();
+
+		m_File.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_File.is_open()) {
+			CHOPPER_LOG_ERROR("Could not open event recording file {}.", path);
+			return false;
+		}
+
+		m_File.write(EventRecordFormat::Magic, sizeof(EventRecordFormat::Magic));
+		WriteValue(m_File, EventRecordFormat::Version);
+
+		m_FirstFrame = frameIndex;
+		m_StartTime = time;
+		m_RecordCount = 0;
+		CHOPPER_LOG_INFO("Recording input events to {}.", path);
+		return true;
+	}
+
+	void EventRecorder::Close() {
+		if (!m_File.is_open())
+			return;
+
+		m_File.close();
+		CHOPPER_LOG_INFO("Event recording stopped, {} events written.", m_RecordCount);
+	}
+
+	void EventRecorder::Record(const Event& e, uint64_t frameIndex, float time) {
+		if (!m_File.is_open())
+			return;
+
+		WriteValue(m_File, static_cast<uint32_t>(frameIndex > m_FirstFrame ? frameIndex - m_FirstFrame : 0));
+		WriteValue(m_File, time - m_StartTime);
+		WriteValue(m_File, static_cast<uint8_t>(e.GetEventType()));
+
+		switch (e.GetEventType()) {
+			case EventType::WindowResize: {
+				const auto& resize = static_cast<const WindowResizeEvent&>(e);
+				WriteValue(m_File, resize.GetWidth());
+				WriteValue(m_File, resize.GetHeight());
+				break;
+			}
+			case EventType::KeyPressed: {
+				const auto& key = static_cast<const KeyPressedEvent&>(e);
+				WriteValue(m_File, static_cast<int32_t>(key.GetKeyCode()));
+				WriteValue(m_File, static_cast<int32_t>(key.GetRepeatCount()));
+				break;
+			}
+			case EventType::KeyReleased:
+				WriteValue(m_File, static_cast<int32_t>(static_cast<const KeyReleasedEvent&>(e).GetKeyCode()));
+				break;
+			case EventType::MouseButtonPressed:
+			case EventType::MouseButtonReleased:
+				WriteValue(m_File, static_cast<int32_t>(static_cast<const MouseButtonEvent&>(e).GetMouseButton()));
+				break;
+			case EventType::MouseMoved: {
+				const auto& moved = static_cast<const MouseMovedEvent&>(e);
+				WriteValue(m_File, moved.GetX());
+				WriteValue(m_File, moved.GetY());
+				break;
+			}
+			case EventType::MouseWheel: {
+				const auto& wheel = static_cast<const MouseWheelEvent&>(e);
+				WriteValue(m_File, wheel.GetXOffset());
+				WriteValue(m_File, wheel.GetYOffset());
+				break;
+			}
+			default:
+				break;
+		}
+
+		++m_RecordCount;
+	}
+
+	bool EventReplayer::Open(const std::string& path, uint64_t frameIndex) {
+		Close();
+
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) {
+			CHOPPER_LOG_ERROR("Could not open event recording file {}.", path);
+			return false;
+		}
+
+		std::streamsize size = file.tellg();
+		file.seekg(0, std::ios::beg);
+		std::vector<uint8_t> data(static_cast<size_t>(size));
+		if (!file.read(reinterpret_cast<char*>(data.data()), size)) {
+			CHOPPER_LOG_ERROR("Could not read event recording file {}.", path);
+			return false;
+		}
+
+		size_t offset = 0;
+		char magic[sizeof(EventRecordFormat::Magic)];
+		uint32_t version = 0;
+		if (!ReadValue(data, offset, magic) || std::memcmp(magic, EventRecordFormat::Magic, sizeof(magic)) != 0
+			|| !ReadValue(data, offset, version) || version != EventRecordFormat::Version) {
+			CHOPPER_LOG_ERROR("{} is not a supported event recording.", path);
+			return false;
+		}
+
+		m_Data = std::move(data);
+		m_Offset = offset;
+		m_FirstFrame = frameIndex;
+		CHOPPER_LOG_INFO("Replaying input events from {}.", path);
+		return true;
+	}
+
+	void EventReplayer::Close() {
+		m_Data.clear();
+		m_Offset = 0;
+	}
+
+	bool EventReplayer::PeekFrame(uint64_t& frame) const {
+		size_t offset = m_Offset;
+		uint32_t relativeFrame;
+		if (!ReadValue(m_Data, offset, relativeFrame))
+			return false;
+
+		frame = m_FirstFrame + relativeFrame;
+		return true;
+	}
+
+	bool EventReplayer::ReadEvent(EventStorage& storage) {
+		uint32_t relativeFrame;
+		float time;
+		uint8_t type;
+		if (!ReadValue(m_Data, m_Offset, relativeFrame) || !ReadValue(m_Data, m_Offset, time) || !ReadValue(m_Data, m_Offset, type))
+			return false;
+
+		bool valid = true;
+		switch (static_cast<EventType>(type)) {
+			case EventType::WindowClose:
+				storage.Store(WindowCloseEvent{});
+				break;
+			case EventType::WindowResize: {
+				uint32_t width, height;
+				valid = ReadValue(m_Data, m_Offset, width) && ReadValue(m_Data, m_Offset, height);
+				storage.Store(WindowResizeEvent{ width, height });
+				break;
+			}
+			case EventType::KeyPressed: {
+				int32_t key, repeat;
+				valid = ReadValue(m_Data, m_Offset, key) && ReadValue(m_Data, m_Offset, repeat);
+				storage.Store(KeyPressedEvent{ static_cast<KeyCode>(key), repeat });
+				break;
+			}
+			case EventType::KeyReleased: {
+				int32_t key;
+				valid = ReadValue(m_Data, m_Offset, key);
+				storage.Store(KeyReleasedEvent{ static_cast<KeyCode>(key) });
+				break;
+			}
+			case EventType::MouseButtonPressed: {
+				int32_t button;
+				valid = ReadValue(m_Data, m_Offset, button);
+				storage.Store(MouseButtonPressedEvent{ static_cast<MouseButtonCode>(button) });
+				break;
+			}
+			case EventType::MouseButtonReleased: {
+				int32_t button;
+				valid = ReadValue(m_Data, m_Offset, button);
+				storage.Store(MouseButtonReleasedEvent{ static_cast<MouseButtonCode>(button) });
+				break;
+			}
+			case EventType::MouseMoved: {
+				float x, y;
+				valid = ReadValue(m_Data, m_Offset, x) && ReadValue(m_Data, m_Offset, y);
+				storage.Store(MouseMovedEvent{ x, y });
+				break;
+			}
+			case EventType::MouseWheel: {
+				float x, y;
+				valid = ReadValue(m_Data, m_Offset, x) && ReadValue(m_Data, m_Offset, y);
+				storage.Store(MouseWheelEvent{ x, y });
+				break;
+			}
+			default:
+				valid = false;
+				break;
+		}
+
+		if (!valid)
+			CHOPPER_LOG_ERROR("Event recording is truncated or corrupted, stopping replay.");
+		return valid;
+	}
+
+}
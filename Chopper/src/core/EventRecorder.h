@@ -0,0 +1,78 @@
+#pragma once
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+#include "Event.h"
+#include "EventQueue.h"
+
+#include <fstream>
+
+namespace Chopper {
+
+	// Binary input capture file:
+	//   header: "CHEV", uint32 version
+	//   record: uint32 frame (relative to the first recorded frame), float seconds since start,
+	//           uint8 event type, then the event fields (native endianness)
+	struct EventRecordFormat {
+		static constexpr char Magic[4] = { 'C', 'H', 'E', 'V' };
+		static constexpr uint32_t Version = 1;
+	};
+
+	class CHOPPER_API EventRecorder {
+	public:
+		EventRecorder() = default;
+		~EventRecorder() { Close(); }
+
+		bool Open(const std::string& path, uint64_t frameIndex, float time);
+		void Close();
+
+		void Record(const Event& e, uint64_t frameIndex, float time);
+
+		inline bool IsOpen() const { return m_File.is_open(); }
+		inline uint32_t GetRecordCount() const { return m_RecordCount; }
+
+	private:
+		std::ofstream m_File;
+		uint64_t m_FirstFrame = 0;
+		float m_StartTime = 0.0f;
+		uint32_t m_RecordCount = 0;
+	};
+
+	class CHOPPER_API EventReplayer {
+	public:
+		// Recorded frame 0 is mapped to frameIndex
+		bool Open(const std::string& path, uint64_t frameIndex);
+		void Close();
+
+		// Calls func(Event&) for every recorded event due at or before frameIndex
+		template<typename F>
+		void Replay(uint64_t frameIndex, F&& func);
+
+		inline bool IsOpen() const { return !m_Data.empty(); }
+		inline bool IsFinished() const { return m_Offset >= m_Data.size(); }
+
+	private:
+		// Decodes the record at the read offset without consuming it
+		bool PeekFrame(uint64_t& frame) const;
+		bool ReadEvent(EventStorage& storage);
+
+		std::vector<uint8_t> m_Data;
+		size_t m_Offset = 0;
+		uint64_t m_FirstFrame = 0;
+	};
+
+	template<typename F>
+	void EventReplayer::Replay(uint64_t frameIndex, F&& func) {
+		uint64_t frame;
+		while (PeekFrame(frame) && frame <= frameIndex) {
+			EventStorage storage;
+			if (!ReadEvent(storage)) {
+				Close();
+				return;
+			}
+			func(storage.Get());
+		}
+	}
+
+}
@@ -0,0 +1,69 @@
+#include "FrameArena.h"
+
+#include "Logger.h"
+#include "Asserts.h"
+
+#include <atomic>
+
+namespace Chopper {
+
+	struct ThreadFrameArena {
+		std::array<LinearAllocator, FrameArena::MaxFrames> Allocators;
+		std::array<uint64_t, FrameArena::MaxFrames> Epochs{};
+		bool Initialized = false;
+	};
+
+	static std::array<LinearAllocator, FrameArena::MaxFrames> s_Allocators;
+	// Bumped every time a frame slot begins, thread arenas compare against it to know when to reset
+	static std::array<std::atomic<uint64_t>, FrameArena::MaxFrames> s_Epochs{};
+	static std::atomic<uint32_t> s_CurrentFrame{ 0 };
+	static std::atomic<size_t> s_BlockSize{ FrameArena::DefaultBlockSize };
+
+	static thread_local ThreadFrameArena s_ThreadArena;
+
+	void FrameArena::Init(size_t blockSize) {
+		s_BlockSize.store(blockSize, std::memory_order_relaxed);
+		for (LinearAllocator& allocator : s_Allocators)
+			allocator.SetBlockSize(blockSize);
+	}
+
+	void FrameArena::Shutdown() {
+		for (LinearAllocator& allocator : s_Allocators)
+			allocator.Release();
+	}
+
+	void FrameArena::BeginFrame(uint32_t frame) {
+		CHOPPER_ASSERT(frame < MaxFrames, "Too many frames in flight for the frame arena!");
+
+		s_Allocators[frame].Reset();
+		s_Epochs[frame].fetch_add(1, std::memory_order_release);
+		s_CurrentFrame.store(frame, std::memory_order_release);
+	}
+
+	uint32_t FrameArena::GetFrameIndex() {
+		return s_CurrentFrame.load(std::memory_order_acquire);
+	}
+
+	LinearAllocator& FrameArena::Get() {
+		return s_Allocators[s_CurrentFrame.load(std::memory_order_relaxed)];
+	}
+
+	LinearAllocator& FrameArena::GetThreadLocal() {
+		ThreadFrameArena& arena = s_ThreadArena;
+		if (!arena.Initialized) {
+			size_t blockSize = s_BlockSize.load(std::memory_order_relaxed);
+			for (LinearAllocator& allocator : arena.Allocators)
+				allocator.SetBlockSize(blockSize);
+			arena.Initialized = true;
+		}
+
+		uint32_t frame = s_CurrentFrame.load(std::memory_order_acquire);
+		uint64_t epoch = s_Epochs[frame].load(std::memory_order_acquire);
+		if (arena.Epochs[frame] != epoch) {
+			arena.Allocators[frame].Reset();
+			arena.Epochs[frame] = epoch;
+		}
+		return arena.Allocators[frame];
+	}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+#include "LinearAllocator.h"
+
+namespace Chopper {
+
+	// One LinearAllocator per frame in flight for transient data of the frame path. A frame's
+	// allocator is reset by BeginFrame() once its in-flight fence signaled, so whatever was
+	// allocated stays valid until the GPU is done with that frame.
+	class CHOPPER_API FrameArena {
+	public:
+		static constexpr uint32_t MaxFrames = 8;
+		static constexpr size_t DefaultBlockSize = 256 * 1024;
+
+		static void Init(size_t blockSize = DefaultBlockSize);
+		// Thread arenas are freed when their thread exits
+		static void Shutdown();
+
+		// Called by the thread driving the renderer right after waiting for the frame's fence
+		static void BeginFrame(uint32_t frame);
+		static uint32_t GetFrameIndex();
+
+		// Allocator of the current frame, only for the thread driving the renderer
+		static LinearAllocator& Get();
+		// Calling thread's allocator for the current frame, for job workers. Reset lazily on
+		// first use after the frame slot came round again.
+		static LinearAllocator& GetThreadLocal();
+
+		static inline void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) { return Get().Allocate(size, alignment); }
+
+		template<typename T>
+		static ArenaAllocator<T> GetAllocator() { return ArenaAllocator<T>(Get()); }
+		template<typename T>
+		static ArenaAllocator<T> GetThreadLocalAllocator() { return ArenaAllocator<T>(GetThreadLocal()); }
+	};
+
+}
@@ -0,0 +1,73 @@
+#include "FrameClock.h"
+
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+namespace Chopper {
+
+	FrameClock::FrameClock()
+		: m_StartTime(Now()), m_FrameStart(m_StartTime) {}
+
+	uint64_t FrameClock::Now() {
+		auto now = std::chrono::steady_clock::now().time_since_epoch();
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+	}
+
+	void FrameClock::Tick() {
+		uint64_t now = Now();
+		float delta = ToSeconds(now - m_FrameStart);
+		m_FrameStart = now;
+
+		// Hitches (breakpoints, window drags, loading) must not explode the simulation
+		m_DeltaTime = std::min(delta, m_MaxDeltaTime);
+		if (m_FrameIndex == 0)
+			m_SmoothedDeltaTime = m_DeltaTime;
+		else
+			m_SmoothedDeltaTime += (m_DeltaTime - m_SmoothedDeltaTime) * m_SmoothingFactor;
+
+		m_WaitTime = 0.0f;
+
+		if (IsFixedTimestepEnabled()) {
+			m_Accumulator += m_DeltaTime;
+			m_FixedStepsThisFrame = 0;
+		}
+	}
+
+	void FrameClock::AddWaitTime(float seconds) {
+		m_WaitTime += seconds;
+	}
+
+	void FrameClock::EndFrame() {
+		m_FrameTime = ToSeconds(Now() - m_FrameStart);
+		m_CpuTime = std::max(m_FrameTime - m_WaitTime, 0.0f);
+		++m_FrameIndex;
+	}
+
+	void FrameClock::SetFixedTimestep(float timestep, uint32_t maxStepsPerFrame) {
+		m_FixedTimestep = timestep;
+		m_MaxFixedSteps = maxStepsPerFrame;
+		m_Accumulator = 0.0f;
+		m_FixedStepsThisFrame = 0;
+	}
+
+	void FrameClock::DisableFixedTimestep() {
+		SetFixedTimestep(0.0f);
+	}
+
+	bool FrameClock::ConsumeFixedStep() {
+		if (!IsFixedTimestepEnabled() || m_Accumulator < m_FixedTimestep)
+			return false;
+
+		if (m_FixedStepsThisFrame >= m_MaxFixedSteps) {
+			// Falling behind; drop the backlog instead of spiraling
+			m_Accumulator = std::fmod(m_Accumulator, m_FixedTimestep);
+			return false;
+		}
+
+		m_Accumulator -= m_FixedTimestep;
+		++m_FixedStepsThisFrame;
+		return true;
+	}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <common/definitions.h>
+
+namespace Chopper {
+
+	class CHOPPER_API FrameClock {
+	public:
+		FrameClock();
+
+		// Monotonic timestamp in nanoseconds
+		static uint64_t Now();
+		static float ToSeconds(uint64_t nanoseconds) { return static_cast<float>(static_cast<double>(nanoseconds) * 1e-9); }
+
+		void Tick();
+		void AddWaitTime(float seconds);
+		void EndFrame();
+
+		// Simulation runs in steps of exactly `timestep` seconds, rendering stays uncapped
+		void SetFixedTimestep(float timestep, uint32_t maxStepsPerFrame = 8);
+		void DisableFixedTimestep();
+		bool ConsumeFixedStep();
+
+		inline uint64_t GetFrameIndex() const { return m_FrameIndex; }
+		inline uint64_t GetFrameStart() const { return m_FrameStart; }
+		inline float GetElapsedTime() const { return ToSeconds(m_FrameStart - m_StartTime); }
+
+		inline float GetDeltaTime() const { return m_DeltaTime; }
+		inline float GetSmoothedDeltaTime() const { return m_SmoothedDeltaTime; }
+		inline float GetCpuTime() const { return m_CpuTime; }
+		inline float GetWaitTime() const { return m_WaitTime; }
+		inline float GetFrameTime() const { return m_FrameTime; }
+
+		inline bool IsFixedTimestepEnabled() const { return m_FixedTimestep > 0.0f; }
+		inline float GetFixedTimestep() const { return m_FixedTimestep; }
+		inline float GetFixedAlpha() const { return IsFixedTimestepEnabled() ? m_Accumulator / m_FixedTimestep : 0.0f; }
+
+		inline void SetMaxDeltaTime(float seconds) { m_MaxDeltaTime = seconds; }
+		inline void SetSmoothingFactor(float factor) { m_SmoothingFactor = factor; }
+
+	private:
+		uint64_t m_StartTime;
+		uint64_t m_FrameStart;
+		uint64_t m_FrameIndex = 0;
+
+		float m_DeltaTime = 0.0f;
+		float m_SmoothedDeltaTime = 0.0f;
+		float m_CpuTime = 0.0f;
+		float m_WaitTime = 0.0f;
+		float m_FrameTime = 0.0f;
+
+		float m_MaxDeltaTime = 0.25f;
+		float m_SmoothingFactor = 0.1f;
+
+		float m_FixedTimestep = 0.0f;
+		float m_Accumulator = 0.0f;
+		uint32_t m_MaxFixedSteps = 8;
+		uint32_t m_FixedStepsThisFrame = 0;
+	};
+
+}
@@ -0,0 +1,124 @@
+#include "FramePacer.h"
+
+#include "FrameClock.h"
+
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+
+#ifdef CHOPPER_WINDOWS_PLATFORM
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <Windows.h>
+	#include <timeapi.h>
+#endif
+
+namespace Chopper {
+
+	static constexpr uint64_t s_MinSpinThreshold = 200000;   // 0.2 ms
+	static constexpr uint64_t s_MaxSpinThreshold = 4000000;  // 4 ms
+	static constexpr float s_StatsSmoothing = 0.05f;
+
+	FramePacer::FramePacer() {
+		SetTargetFrameRate(m_TargetFrameRate);
+	}
+
+	FramePacer::~FramePacer() {
+		SetMode(FramePacingMode::Unlimited);
+	}
+
+	void FramePacer::SetMode(FramePacingMode mode) {
+		m_Mode = mode;
+		m_NextDeadline = 0;
+
+#ifdef CHOPPER_WINDOWS_PLATFORM
+		// Default scheduler granularity (~15.6 ms) is too coarse to sleep for part of a frame
+		bool wantHighResolution = mode == FramePacingMode::TargetFrameRate;
+		if (wantHighResolution != m_HighResolutionTimer) {
+			if (wantHighResolution)
+				timeBeginPeriod(1);
+			else
+				timeEndPeriod(1);
+			m_HighResolutionTimer = wantHighResolution;
+		}
+#endif
+	}
+
+	void FramePacer::SetTargetFrameRate(float framesPerSecond) {
+		m_TargetFrameRate = std::max(framesPerSecond, 1.0f);
+		m_FramePeriod = static_cast<uint64_t>(1e9 / m_TargetFrameRate);
+		m_NextDeadline = 0;
+		m_Stats.TargetFrameTime = FrameClock::ToSeconds(m_FramePeriod);
+	}
+
+	float FramePacer::Wait() {
+		if (m_Mode == FramePacingMode::Unlimited)
+			return 0.0f;
+
+		uint64_t waitStart = FrameClock::Now();
+		if (m_NextDeadline == 0) {
+			m_NextDeadline = waitStart + m_FramePeriod;
+			m_LastFrameEnd = waitStart;
+		}
+
+		if (waitStart > m_NextDeadline) {
+			++m_Stats.MissedDeadlines;
+			// Too far behind to catch up without a burst of short frames, restart the schedule
+			if (waitStart - m_NextDeadline > m_FramePeriod)
+				m_NextDeadline = waitStart;
+		}
+		else {
+			SleepUntil(m_NextDeadline);
+		}
+
+		uint64_t frameEnd = FrameClock::Now();
+		float frameTime = FrameClock::ToSeconds(frameEnd - m_LastFrameEnd);
+		float jitter = std::abs(frameTime - m_Stats.TargetFrameTime);
+
+		if (m_Stats.PacedFrames == 0) {
+			m_Stats.AverageFrameTime = frameTime;
+			m_Stats.Jitter = jitter;
+		}
+		else {
+			m_Stats.AverageFrameTime += (frameTime - m_Stats.AverageFrameTime) * s_StatsSmoothing;
+			m_Stats.Jitter += (jitter - m_Stats.Jitter) * s_StatsSmoothing;
+		}
+		m_Stats.MaxJitter = std::max(m_Stats.MaxJitter, jitter);
+		m_Stats.SpinThreshold = FrameClock::ToSeconds(m_SpinThreshold);
+		++m_Stats.PacedFrames;
+
+		m_LastFrameEnd = frameEnd;
+		m_NextDeadline += m_FramePeriod;
+
+		return FrameClock::ToSeconds(frameEnd - waitStart);
+	}
+
+	void FramePacer::ResetStats() {
+		m_Stats = {};
+		m_Stats.TargetFrameTime = FrameClock::ToSeconds(m_FramePeriod);
+	}
+
+	void FramePacer::SleepUntil(uint64_t deadline) {
+		uint64_t now = FrameClock::Now();
+
+		if (deadline > now && deadline - now > m_SpinThreshold) {
+			uint64_t wakeTarget = deadline - m_SpinThreshold;
+			std::this_thread::sleep_for(std::chrono::nanoseconds(wakeTarget - now));
+
+			// Grow quickly to absorb oversleep spikes, decay slowly when the scheduler behaves
+			now = FrameClock::Now();
+			uint64_t oversleep = now > wakeTarget ? now - wakeTarget : 0;
+			uint64_t wanted = oversleep + oversleep / 4;
+			if (wanted > m_SpinThreshold)
+				m_SpinThreshold = wanted;
+			else
+				m_SpinThreshold -= (m_SpinThreshold - wanted) / 64;
+			m_SpinThreshold = std::clamp(m_SpinThreshold, s_MinSpinThreshold, s_MaxSpinThreshold);
+		}
+
+		while (FrameClock::Now() < deadline)
+			std::this_thread::yield();
+	}
+
+}
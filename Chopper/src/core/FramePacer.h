@@ -0,0 +1,56 @@
+#pragma once
+
+#include <common/definitions.h>
+
+namespace Chopper {
+
+	enum class FramePacingMode {
+		Unlimited = 0,
+		TargetFrameRate
+	};
+
+	// All times in seconds
+	struct FramePacingStats {
+		float TargetFrameTime = 0.0f;
+		float AverageFrameTime = 0.0f;
+		float Jitter = 0.0f;
+		float MaxJitter = 0.0f;
+		float SpinThreshold = 0.0f;
+		uint64_t PacedFrames = 0;
+		uint64_t MissedDeadlines = 0;
+	};
+
+	class CHOPPER_API FramePacer {
+	public:
+		FramePacer();
+		~FramePacer();
+
+		void SetMode(FramePacingMode mode);
+		void SetTargetFrameRate(float framesPerSecond);
+
+		// Blocks until the next frame deadline. Returns the time spent waiting.
+		float Wait();
+
+		inline FramePacingMode GetMode() const { return m_Mode; }
+		inline float GetTargetFrameRate() const { return m_TargetFrameRate; }
+		inline const FramePacingStats& GetStats() const { return m_Stats; }
+		void ResetStats();
+
+	private:
+		void SleepUntil(uint64_t deadline);
+
+		FramePacingMode m_Mode = FramePacingMode::Unlimited;
+		float m_TargetFrameRate = 60.0f;
+		uint64_t m_FramePeriod = 0;
+
+		uint64_t m_NextDeadline = 0;
+		uint64_t m_LastFrameEnd = 0;
+
+		// Remaining time that is spun instead of slept, adapted to the observed OS oversleep
+		uint64_t m_SpinThreshold = 2000000;
+		bool m_HighResolutionTimer = false;
+
+		FramePacingStats m_Stats{};
+	};
+
+}
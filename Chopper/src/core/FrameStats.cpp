@@ -0,0 +1,149 @@
+#include "FrameStats.h"
+
+#include "Logger.h"
+
+#include <cmath>
+#include <fstream>
+
+namespace Chopper {
+
+	static constexpr float s_AverageSmoothing = 0.1f;
+
+	FrameStats::FrameStats(uint32_t windowSize)
+		: m_Entries(std::max(windowSize, 1u)), m_Scratch(std::max(windowSize, 1u)) {}
+
+	void FrameStats::Push(uint64_t frameIndex, const FrameSample& sample) {
+		Entry& entry = m_Entries[m_Head];
+		if (m_Count == m_Entries.size()) {
+			if (entry.Stutter)
+				--m_WindowStutterCount;
+		}
+		else
+			++m_Count;
+
+		bool stutter = m_AverageFrameTime > 0.0f && sample.FrameTime > m_AverageFrameTime * m_StutterFactor;
+		if (stutter) {
+			++m_WindowStutterCount;
+			++m_TotalStutterCount;
+		}
+
+		// Spikes are clamped so a single hitch does not hide the ones right after it
+		float frameTime = std::min(sample.FrameTime, m_AverageFrameTime > 0.0f ? m_AverageFrameTime * m_StutterFactor : sample.FrameTime);
+		if (m_AverageFrameTime > 0.0f)
+			m_AverageFrameTime += (frameTime - m_AverageFrameTime) * s_AverageSmoothing;
+		else
+			m_AverageFrameTime = frameTime;
+
+		entry.Sample = sample;
+		entry.FrameIndex = frameIndex;
+		entry.Stutter = stutter;
+		m_Head = (m_Head + 1) % static_cast<uint32_t>(m_Entries.size());
+	}
+
+	void FrameStats::Clear() {
+		m_Head = 0;
+		m_Count = 0;
+		m_AverageFrameTime = 0.0f;
+		m_WindowStutterCount = 0;
+		m_TotalStutterCount = 0;
+	}
+
+	FrameMetricSummary FrameStats::GetSummary(FrameMetric metric) const {
+		FrameMetricSummary summary{};
+		if (m_Count == 0)
+			return summary;
+
+		for (uint32_t i = 0; i < m_Count; ++i)
+			m_Scratch[i] = GetMetric(m_Entries[i].Sample, metric);
+
+		auto begin = m_Scratch.begin();
+		auto end = begin + m_Count;
+		// Nearest rank, each partition narrows the range searched by the next one
+		auto rank = [&](float percentile) {
+			uint32_t index = static_cast<uint32_t>(std::ceil(percentile * m_Count));
+			return begin + (std::max(index, 1u) - 1);
+		};
+
+		auto p50 = rank(0.50f);
+		std::nth_element(begin, p50, end);
+		auto p95 = rank(0.95f);
+		std::nth_element(p50, p95, end);
+		auto p99 = rank(0.99f);
+		std::nth_element(p95, p99, end);
+
+		summary.P50 = *p50;
+		summary.P95 = *p95;
+		summary.P99 = *p99;
+		summary.Max = *std::max_element(p99, end);
+		return summary;
+	}
+
+	bool FrameStats::WriteCsv(const std::string& path) const {
+		std::ofstream file(path, std::ios::trunc);
+		if (!file.is_open()) {
+			CHOPPER_LOG_ERROR("Could not open frame statistics file {}.", path);
+			return false;
+		}
+
+		file << "frame";
+		for (uint32_t metric = 0; metric < static_cast<uint32_t>(FrameMetric::Count); ++metric)
+			file << ',' << GetMetricName(static_cast<FrameMetric>(metric)) << "_ms";
+		file << ",allocations,allocated_bytes,stutter\n";
+
+		file.setf(std::ios::fixed);
+		file.precision(4);
+
+		uint32_t first = (m_Head + static_cast<uint32_t>(m_Entries.size()) - m_Count) % static_cast<uint32_t>(m_Entries.size());
+		for (uint32_t i = 0; i < m_Count; ++i) {
+			const Entry& entry = m_Entries[(first + i) % m_Entries.size()];
+			file << entry.FrameIndex;
+			for (uint32_t metric = 0; metric < static_cast<uint32_t>(FrameMetric::Count); ++metric)
+				file << ',' << GetMetric(entry.Sample, static_cast<FrameMetric>(metric)) * 1000.0f;
+			file << ',' << entry.Sample.Allocations << ',' << entry.Sample.AllocatedBytes;
+			file << ',' << (entry.Stutter ? 1 : 0) << '\n';
+		}
+
+		if (!file.good()) {
+			CHOPPER_LOG_ERROR("Failed to write frame statistics file {}.", path);
+			return false;
+		}
+
+		CHOPPER_LOG_INFO("Frame statistics of {} frames written to {}.", m_Count, path);
+		return true;
+	}
+
+	void FrameStats::LogSummary() const {
+		CHOPPER_LOG_INFO("Frame statistics over {} frames, {} stutters ({} in total):", m_Count, m_WindowStutterCount, m_TotalStutterCount);
+		for (uint32_t metric = 0; metric < static_cast<uint32_t>(FrameMetric::Count); ++metric) {
+			FrameMetricSummary summary = GetSummary(static_cast<FrameMetric>(metric));
+			CHOPPER_LOG_INFO("  {:<14} p50 {:7.3f} ms, p95 {:7.3f} ms, p99 {:7.3f} ms, max {:7.3f} ms",
+				GetMetricName(static_cast<FrameMetric>(metric)),
+				summary.P50 * 1000.0f, summary.P95 * 1000.0f, summary.P99 * 1000.0f, summary.Max * 1000.0f);
+		}
+	}
+
+	const char* FrameStats::GetMetricName(FrameMetric metric) {
+		switch (metric) {
+			case FrameMetric::FrameTime:     return "frame";
+			case FrameMetric::CpuTime:       return "cpu";
+			case FrameMetric::GpuTime:       return "gpu";
+			case FrameMetric::FenceWaitTime: return "fence_wait";
+			case FrameMetric::AcquireTime:   return "acquire";
+			case FrameMetric::PresentTime:   return "present";
+			default:                         return "unknown";
+		}
+	}
+
+	float FrameStats::GetMetric(const FrameSample& sample, FrameMetric metric) {
+		switch (metric) {
+			case FrameMetric::FrameTime:     return sample.FrameTime;
+			case FrameMetric::CpuTime:       return sample.CpuTime;
+			case FrameMetric::GpuTime:       return sample.GpuTime;
+			case FrameMetric::FenceWaitTime: return sample.FenceWaitTime;
+			case FrameMetric::AcquireTime:   return sample.AcquireTime;
+			case FrameMetric::PresentTime:   return sample.PresentTime;
+			default:                         return 0.0f;
+		}
+	}
+
+}
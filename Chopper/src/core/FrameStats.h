@@ -0,0 +1,90 @@
+#pragma once
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+namespace Chopper {
+
+	// Seconds
+	struct FrameSample {
+		float FrameTime = 0.0f;
+		float CpuTime = 0.0f;
+		float GpuTime = 0.0f;
+		float FenceWaitTime = 0.0f;
+		float AcquireTime = 0.0f;
+		float PresentTime = 0.0f;
+
+		// Heap allocations made during the frame, zero unless built with CHOPPER_TRACK_ALLOCATIONS
+		uint32_t Allocations = 0;
+		uint64_t AllocatedBytes = 0;
+	};
+
+	enum class FrameMetric {
+		FrameTime,
+		CpuTime,
+		GpuTime,
+		FenceWaitTime,
+		AcquireTime,
+		PresentTime,
+		Count
+	};
+
+	struct FrameMetricSummary {
+		float P50 = 0.0f;
+		float P95 = 0.0f;
+		float P99 = 0.0f;
+		float Max = 0.0f;
+	};
+
+	// Rolling window of per-frame timings. A frame is a stutter when its frame time exceeds the
+	// moving average of the previous frames by the stutter factor. All storage is allocated up
+	// front, pushing a frame and computing percentiles never allocate.
+	class CHOPPER_API FrameStats {
+	public:
+		FrameStats(uint32_t windowSize = 1024);
+
+		void Push(uint64_t frameIndex, const FrameSample& sample);
+		void Clear();
+
+		// Percentiles over the frames currently in the window
+		FrameMetricSummary GetSummary(FrameMetric metric) const;
+
+		inline uint32_t GetSampleCount() const { return m_Count; }
+		inline uint32_t GetWindowSize() const { return static_cast<uint32_t>(m_Entries.size()); }
+		inline const FrameSample& GetLatest() const { return m_Entries[(m_Head + m_Entries.size() - 1) % m_Entries.size()].Sample; }
+
+		// Stutters still in the window and since the last Clear
+		inline uint32_t GetStutterCount() const { return m_WindowStutterCount; }
+		inline uint64_t GetTotalStutterCount() const { return m_TotalStutterCount; }
+
+		inline void SetStutterFactor(float factor) { m_StutterFactor = factor; }
+		inline float GetStutterFactor() const { return m_StutterFactor; }
+
+		// One row per frame in the window, oldest first
+		bool WriteCsv(const std::string& path) const;
+		void LogSummary() const;
+
+		static const char* GetMetricName(FrameMetric metric);
+
+	private:
+		static float GetMetric(const FrameSample& sample, FrameMetric metric);
+
+		struct Entry {
+			FrameSample Sample;
+			uint64_t FrameIndex;
+			bool Stutter;
+		};
+
+		std::vector<Entry> m_Entries;
+		mutable std::vector<float> m_Scratch;
+
+		uint32_t m_Head = 0;
+		uint32_t m_Count = 0;
+
+		float m_AverageFrameTime = 0.0f;
+		float m_StutterFactor = 2.0f;
+		uint32_t m_WindowStutterCount = 0;
+		uint64_t m_TotalStutterCount = 0;
+	};
+
+}
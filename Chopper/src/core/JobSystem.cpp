@@ -0,0 +1,395 @@
+#include "JobSystem.h"
+
+#include "Logger.h"
+#include "Asserts.h"
+#include "Profiler.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+namespace Chopper {
+
+	static constexpr int64_t s_DequeCapacity = 1024;
+	static constexpr uint32_t s_IdleSpinCount = 64;
+
+	// Chase-Lev work-stealing deque (Le et al., "Correct and Efficient Work-Stealing for Weak
+	// Memory Models"). The owner pushes and pops at the bottom, thieves steal from the top.
+	// Jobs are stored by value: a slot is only rewritten once top moved past it, so a thief
+	// copies the job before claiming it and drops the copy when the claim fails.
+	class WorkStealingDeque {
+	public:
+		bool Push(const Job& job) {
+			int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+			int64_t top = m_Top.load(std::memory_order_acquire);
+			if (bottom - top >= s_DequeCapacity)
+				return false;
+
+			m_Buffer[bottom & (s_DequeCapacity - 1)] = job;
+			m_Bottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool Pop(Job& job) {
+			int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+			m_Bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t top = m_Top.load(std::memory_order_relaxed);
+
+			if (top > bottom) {
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			job = m_Buffer[bottom & (s_DequeCapacity - 1)];
+			if (top == bottom) {
+				// Last element, race against thieves for it
+				bool won = m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+				return won;
+			}
+			return true;
+		}
+
+		bool Steal(Job& job) {
+			int64_t top = m_Top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+			if (top >= bottom)
+				return false;
+
+			Job stolen = m_Buffer[top & (s_DequeCapacity - 1)];
+			if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return false;
+			job = stolen;
+			return true;
+		}
+
+		int64_t Size() const {
+			int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+			int64_t top = m_Top.load(std::memory_order_relaxed);
+			return bottom > top ? bottom - top : 0;
+		}
+
+	private:
+		alignas(64) std::atomic<int64_t> m_Top{ 0 };
+		alignas(64) std::atomic<int64_t> m_Bottom{ 0 };
+		Job m_Buffer[s_DequeCapacity];
+	};
+
+	struct Worker {
+		uint32_t Index = 0;
+		WorkStealingDeque Deque;
+		uint32_t RandomState = 0;
+		std::thread Thread;
+	};
+
+	static std::vector<std::unique_ptr<Worker>> s_Workers;
+	static thread_local Worker* s_ThisWorker = nullptr;
+	static std::atomic<bool> s_Running{ false };
+
+	// Jobs submitted from threads that are not workers, or when a deque is full
+	static std::mutex s_InjectionMutex;
+	static std::deque<Job> s_InjectionQueue;
+	static std::atomic<uint32_t> s_InjectedJobs{ 0 };
+
+	static std::mutex s_SleepMutex;
+	static std::condition_variable s_WakeCondition;
+	static std::atomic<uint32_t> s_QueuedJobs{ 0 };
+	static std::atomic<uint32_t> s_SleepingWorkers{ 0 };
+
+	// Jobs whose dependency was not done yet, released by the job that finishes it
+	static std::mutex s_ParkedMutex;
+	static std::vector<Job> s_ParkedJobs;
+	static std::atomic<uint32_t> s_ParkedCount{ 0 };
+
+	static void WakeWorkers() {
+		if (s_SleepingWorkers.load(std::memory_order_seq_cst) > 0) {
+			std::lock_guard<std::mutex> lock(s_SleepMutex);
+			s_WakeCondition.notify_one();
+		}
+	}
+
+	static void InjectJob(const Job& job) {
+		{
+			std::lock_guard<std::mutex> lock(s_InjectionMutex);
+			s_InjectionQueue.push_back(job);
+		}
+		s_InjectedJobs.fetch_add(1, std::memory_order_release);
+		s_QueuedJobs.fetch_add(1, std::memory_order_seq_cst);
+		WakeWorkers();
+	}
+
+	static bool PopInjectedJob(Job& job) {
+		if (s_InjectedJobs.load(std::memory_order_acquire) == 0)
+			return false;
+
+		std::lock_guard<std::mutex> lock(s_InjectionMutex);
+		if (s_InjectionQueue.empty())
+			return false;
+
+		job = s_InjectionQueue.front();
+		s_InjectionQueue.pop_front();
+		s_InjectedJobs.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	static void PushJob(const Job& job) {
+		Worker* worker = s_ThisWorker;
+		if (!worker) {
+			InjectJob(job);
+			return;
+		}
+
+		if (!worker->Deque.Push(job)) {
+			InjectJob(job);
+			return;
+		}
+
+		s_QueuedJobs.fetch_add(1, std::memory_order_seq_cst);
+		WakeWorkers();
+	}
+
+	static bool FindJob(Job& job) {
+		Worker* self = s_ThisWorker;
+		if (self) {
+			if (self->Deque.Pop(job)) {
+				s_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+
+		if (PopInjectedJob(job)) {
+			s_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		uint32_t workerCount = static_cast<uint32_t>(s_Workers.size());
+		if (workerCount == 0)
+			return false;
+
+		// xorshift32, only used to spread thieves over victims
+		uint32_t start = 0;
+		if (self) {
+			uint32_t x = self->RandomState;
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			self->RandomState = x;
+			start = x % workerCount;
+		}
+
+		for (uint32_t i = 0; i < workerCount; ++i) {
+			Worker* victim = s_Workers[(start + i) % workerCount].get();
+			if (victim == self)
+				continue;
+			if (victim->Deque.Steal(job)) {
+				s_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// False when the dependency finished in the meantime and the job can run right away
+	static bool ParkJob(const Job& job) {
+		std::lock_guard<std::mutex> lock(s_ParkedMutex);
+		// Counted before checking, the finishing job checks the count after its decrement
+		s_ParkedCount.fetch_add(1, std::memory_order_seq_cst);
+		if (job.Dependency->Value.load(std::memory_order_seq_cst) == 0) {
+			s_ParkedCount.fetch_sub(1, std::memory_order_relaxed);
+			return false;
+		}
+		s_ParkedJobs.push_back(job);
+		return true;
+	}
+
+	static void ReleaseParkedJobs() {
+		if (s_ParkedCount.load(std::memory_order_seq_cst) == 0)
+			return;
+
+		std::lock_guard<std::mutex> lock(s_ParkedMutex);
+		for (size_t i = 0; i < s_ParkedJobs.size();) {
+			if (!s_ParkedJobs[i].Dependency->IsDone()) {
+				++i;
+				continue;
+			}
+			PushJob(s_ParkedJobs[i]);
+			s_ParkedJobs[i] = s_ParkedJobs.back();
+			s_ParkedJobs.pop_back();
+			s_ParkedCount.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	static void ExecuteJob(Job job) {
+		if (job.Dependency && !job.Dependency->IsDone() && ParkJob(job))
+			return;
+
+		// Lazy binary splitting: only hand out halves while there is nothing left to steal
+		uint32_t end = job.End;
+		while (job.Grain && end - job.Begin > job.Grain && (!s_ThisWorker || s_ThisWorker->Deque.Size() < 2)) {
+			uint32_t middle = job.Begin + (end - job.Begin) / 2;
+
+			Job upperHalf = job;
+			upperHalf.Begin = middle;
+			upperHalf.End = end;
+			upperHalf.Dependency = nullptr;
+			if (job.Counter)
+				job.Counter->Value.fetch_add(1, std::memory_order_relaxed);
+			PushJob(upperHalf);
+
+			end = middle;
+		}
+
+		{
+			CHOPPER_PROFILE_SCOPE("JobSystem::Job");
+			job.EntryPoint(job.UserData, job.Begin, end);
+		}
+
+		if (job.Counter && job.Counter->Value.fetch_sub(1, std::memory_order_seq_cst) == 1)
+			ReleaseParkedJobs();
+	}
+
+	static void WorkerMain(Worker* worker) {
+		s_ThisWorker = worker;
+#ifdef CHOPPER_PROFILING_ENABLED
+		std::string threadName = "Job Worker " + std::to_string(worker->Index);
+		Profiler::SetThreadName(threadName.c_str());
+#endif
+
+		uint32_t idleSpins = 0;
+		while (s_Running.load(std::memory_order_acquire)) {
+			Job job;
+			if (FindJob(job)) {
+				ExecuteJob(job);
+				idleSpins = 0;
+				continue;
+			}
+
+			if (++idleSpins < s_IdleSpinCount) {
+				std::this_thread::yield();
+				continue;
+			}
+			idleSpins = 0;
+
+			std::unique_lock<std::mutex> lock(s_SleepMutex);
+			s_SleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+			if (s_QueuedJobs.load(std::memory_order_seq_cst) == 0 && s_Running.load(std::memory_order_acquire))
+				s_WakeCondition.wait(lock);
+			s_SleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		s_ThisWorker = nullptr;
+	}
+
+	void JobSystem::Init(uint32_t workerCount) {
+		CHOPPER_ASSERT(s_Workers.empty(), "Job System already initialized!");
+
+		if (workerCount == 0)
+			workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+		s_Running.store(true, std::memory_order_release);
+		for (uint32_t i = 0; i < workerCount; ++i) {
+			auto worker = std::make_unique<Worker>();
+			worker->Index = i;
+			worker->RandomState = 0x9E3779B9u * (i + 1);
+			s_Workers.emplace_back(std::move(worker));
+		}
+
+		// Worker 0 is the calling thread, it only runs jobs while waiting
+		s_ThisWorker = s_Workers[0].get();
+		for (uint32_t i = 1; i < workerCount; ++i)
+			s_Workers[i]->Thread = std::thread(WorkerMain, s_Workers[i].get());
+
+		CHOPPER_LOG_INFO("Job System initialized with {} workers.", workerCount);
+	}
+
+	void JobSystem::Shutdown() {
+		if (s_Workers.empty())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(s_SleepMutex);
+			s_Running.store(false, std::memory_order_release);
+			s_WakeCondition.notify_all();
+		}
+
+		for (auto& worker : s_Workers) {
+			if (worker->Thread.joinable())
+				worker->Thread.join();
+		}
+
+		s_ThisWorker = nullptr;
+		s_Workers.clear();
+		s_InjectionQueue.clear();
+		s_ParkedJobs.clear();
+		s_ParkedCount.store(0);
+		s_InjectedJobs.store(0);
+		s_QueuedJobs.store(0);
+		CHOPPER_LOG_DEBUG("Job System shut down.");
+	}
+
+	void JobSystem::Run(const Job* jobs, uint32_t count, JobCounter* counter, const JobCounter* dependency) {
+		if (counter)
+			counter->Value.fetch_add(count, std::memory_order_relaxed);
+
+		for (uint32_t i = 0; i < count; ++i) {
+			Job job = jobs[i];
+			job.Counter = counter;
+			if (dependency)
+				job.Dependency = dependency;
+			PushJob(job);
+		}
+	}
+
+	void JobSystem::Run(JobEntryPoint entryPoint, void* userData, JobCounter* counter, const JobCounter* dependency) {
+		Job job{};
+		job.EntryPoint = entryPoint;
+		job.UserData = userData;
+		Run(&job, 1, counter, dependency);
+	}
+
+	void JobSystem::Wait(const JobCounter* counter) {
+		while (!counter->IsDone()) {
+			Job job;
+			if (FindJob(job))
+				ExecuteJob(job);
+			else
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::ParallelForImpl(uint32_t count, uint32_t minGrain, JobEntryPoint entryPoint, void* userData) {
+		if (count == 0)
+			return;
+
+		// Splitting is lazy, the grain only bounds how small a stolen range can get
+		uint32_t workerCount = std::max(GetWorkerCount(), 1u);
+		uint32_t grain = std::max({ minGrain, count / (workerCount * 32), 1u });
+
+		JobCounter counter;
+		counter.Value.store(1, std::memory_order_relaxed);
+
+		Job job{};
+		job.EntryPoint = entryPoint;
+		job.UserData = userData;
+		job.Begin = 0;
+		job.End = count;
+		job.Grain = s_Workers.empty() ? 0 : grain;
+		job.Counter = &counter;
+
+		ExecuteJob(job);
+		Wait(&counter);
+	}
+
+	uint32_t JobSystem::GetWorkerCount() {
+		return static_cast<uint32_t>(s_Workers.size());
+	}
+
+	bool JobSystem::IsWorkerThread() {
+		return s_ThisWorker != nullptr;
+	}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+#include <atomic>
+#include <type_traits>
+
+namespace Chopper {
+
+	struct JobCounter {
+		std::atomic<uint32_t> Value{ 0 };
+
+		inline bool IsDone() const { return Value.load(std::memory_order_acquire) == 0; }
+	};
+
+	using JobEntryPoint = void(*)(void* userData, uint32_t begin, uint32_t end);
+
+	struct Job {
+		JobEntryPoint EntryPoint = nullptr;
+		void* UserData = nullptr;
+		uint32_t Begin = 0;
+		uint32_t End = 1;
+		// Ranges larger than this are split while other workers are starving, 0 disables splitting
+		uint32_t Grain = 0;
+		JobCounter* Counter = nullptr;
+		const JobCounter* Dependency = nullptr;
+	};
+
+	class CHOPPER_API JobSystem {
+	public:
+		// Registers the calling thread as worker 0. A worker count of 0 uses every hardware thread.
+		static void Init(uint32_t workerCount = 0);
+		static void Shutdown();
+
+		// Increments the counter by `count`, each job decrements it once finished.
+		// Jobs with a dependency are not started before that counter reaches zero.
+		static void Run(const Job* jobs, uint32_t count, JobCounter* counter, const JobCounter* dependency = nullptr);
+		static void Run(JobEntryPoint entryPoint, void* userData, JobCounter* counter, const JobCounter* dependency = nullptr);
+
+		// Executes pending jobs on the calling thread until the counter reaches zero
+		static void Wait(const JobCounter* counter);
+
+		// Calls func(i) for every i in [0, count), blocking until all calls returned
+		template<typename F>
+		static void ParallelFor(uint32_t count, F&& func, uint32_t minGrain = 1);
+
+		static uint32_t GetWorkerCount();
+		static bool IsWorkerThread();
+
+	private:
+		static void ParallelForImpl(uint32_t count, uint32_t minGrain, JobEntryPoint entryPoint, void* userData);
+	};
+
+	template<typename F>
+	void JobSystem::ParallelFor(uint32_t count, F&& func, uint32_t minGrain) {
+		using FuncType = std::remove_reference_t<F>;
+		JobEntryPoint entryPoint = [](void* userData, uint32_t begin, uint32_t end) {
+			FuncType& f = *static_cast<FuncType*>(userData);
+			for (uint32_t i = begin; i < end; ++i)
+				f(i);
+		};
+		ParallelForImpl(count, minGrain, entryPoint, const_cast<void*>(static_cast<const void*>(&func)));
+	}
+
+}
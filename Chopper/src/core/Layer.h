@@ -8,14 +8,21 @@ namespace Chopper {
 
 	class CHOPPER_API Layer {
 	public:
-		Layer() {}
+		// Only events whose category is in the mask are delivered to OnEvent
+		Layer(uint32_t eventMask = EventCategoryAll) : m_EventMask(eventMask) {}
 		virtual ~Layer() {}
 
 		virtual void OnAttach() {}
 		virtual void OnDetach() {}
 		virtual void OnUpdate(float deltaTime) {}
+		virtual void OnFixedUpdate(float fixedDeltaTime) {}
 		virtual void OnImGuiRender() {}
 		virtual void OnEvent(Event& e) {}
+
+		inline uint32_t GetEventMask() const { return m_EventMask; }
+
+	private:
+		uint32_t m_EventMask;
 	};
 
 }
@@ -15,6 +15,7 @@ namespace Chopper {
 	void LayerStack::PushLayer(Layer* layer) {
 		m_Layers.emplace(m_Layers.begin() + m_LayerInsertIndex, layer);
 		++m_LayerInsertIndex;
+		RebuildSubscribers();
 	}
 
 	void LayerStack::PopLayer(Layer* layer) {
@@ -25,11 +26,13 @@ namespace Chopper {
 			layer->OnDetach();
 			m_Layers.erase(it);
 			--m_LayerInsertIndex;
+			RebuildSubscribers();
 		}
 	}
 
 	void LayerStack::PushOverlay(Layer* overlay) {
 		m_Layers.emplace_back(overlay);
+		RebuildSubscribers();
 	}
 
 	void LayerStack::PopOverlay(Layer* overlay) {
@@ -39,6 +42,20 @@ namespace Chopper {
 		if (it != endIt) {
 			overlay->OnDetach();
 			m_Layers.erase(it);
+			RebuildSubscribers();
+		}
+	}
+
+	void LayerStack::RebuildSubscribers() {
+		for (auto& subscribers : m_Subscribers)
+			subscribers.clear();
+
+		for (auto it = m_Layers.rbegin(); it != m_Layers.rend(); ++it) {
+			uint32_t mask = (*it)->GetEventMask();
+			for (uint32_t i = 0; i < EventCategoryCount; ++i) {
+				if (mask & (1u << i))
+					m_Subscribers[i].push_back(*it);
+			}
 		}
 	}
 
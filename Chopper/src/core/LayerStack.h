@@ -17,6 +17,9 @@ namespace Chopper {
 		void PushOverlay(Layer* overlayer);
 		void PopOverlay(Layer* overlayer);
 
+		// Layers subscribed to the event's category, topmost first
+		inline const std::vector<Layer*>& GetSubscribers(EventType type) const { return m_Subscribers[GetEventCategoryIndex(type)]; }
+
 		std::vector<Layer*>::iterator begin() { return m_Layers.begin(); }
 		std::vector<Layer*>::iterator end() { return m_Layers.end(); }
 		std::vector<Layer*>::reverse_iterator rbegin() { return m_Layers.rbegin(); }
@@ -28,7 +31,11 @@ namespace Chopper {
 		std::vector<Layer*>::const_reverse_iterator crend() const { return m_Layers.crend(); }
 
 	private:
+		void RebuildSubscribers();
+
 		std::vector<Layer*> m_Layers;
+		// One extra list, always empty, for events without a category
+		std::array<std::vector<Layer*>, EventCategoryCount + 1> m_Subscribers;
 		uint32_t m_LayerInsertIndex;
 	};
 
@@ -0,0 +1,84 @@
+#include "LinearAllocator.h"
+
+#include "Logger.h"
+#include "Asserts.h"
+
+namespace Chopper {
+
+	static inline size_t AlignUp(size_t value, size_t alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+
+	LinearAllocator::LinearAllocator(size_t blockSize)
+		: m_BlockSize(blockSize) {}
+
+	LinearAllocator::~LinearAllocator() {
+		Release();
+	}
+
+	void* LinearAllocator::Allocate(size_t size, size_t alignment) {
+		CHOPPER_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two!");
+
+		while (m_Current) {
+			uintptr_t base = reinterpret_cast<uintptr_t>(GetData(m_Current));
+			size_t offset = AlignUp(base + m_Offset, alignment) - base;
+			if (offset + size <= m_Current->Size) {
+				m_UsedSize += offset + size - m_Offset;
+				m_Offset = offset + size;
+				return GetData(m_Current) + offset;
+			}
+
+			// The tail of a block that is left behind counts as used, it is gone until the next reset
+			m_UsedSize += m_Current->Size - m_Offset;
+			m_Offset = m_Current->Size;
+			if (!m_Current->Next)
+				break;
+			m_Current = m_Current->Next;
+			m_Offset = 0;
+		}
+
+		Block* block = CreateBlock(std::max(m_BlockSize, size + alignment));
+		if (m_Current)
+			m_Current->Next = block;
+		else
+			m_Head = block;
+		m_Current = block;
+		m_Offset = 0;
+		return Allocate(size, alignment);
+	}
+
+	void LinearAllocator::Reset() {
+		m_PeakSize = std::max(m_PeakSize, m_UsedSize);
+		if (m_Head && m_Head->Next) {
+			size_t capacity = (m_PeakSize + m_BlockSize - 1) / m_BlockSize * m_BlockSize;
+			Release();
+			m_Head = CreateBlock(capacity);
+		}
+
+		m_Current = m_Head;
+		m_Offset = 0;
+		m_UsedSize = 0;
+	}
+
+	void LinearAllocator::Release() {
+		Block* block = m_Head;
+		while (block) {
+			Block* next = block->Next;
+			::operator delete(block);
+			block = next;
+		}
+
+		m_Head = nullptr;
+		m_Current = nullptr;
+		m_Offset = 0;
+		m_UsedSize = 0;
+		m_Capacity = 0;
+	}
+
+	LinearAllocator::Block* LinearAllocator::CreateBlock(size_t size) {
+		Block* block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+		block->Next = nullptr;
+		block->Size = size;
+		m_Capacity += size;
+		return block;
+	}
+
+}
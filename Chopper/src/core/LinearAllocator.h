@@ -0,0 +1,98 @@
+#pragma once
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace Chopper {
+
+	// Bump allocator over a chain of blocks. Memory is only given back all at once by Reset().
+	// Blocks chained during a cycle are merged into one on Reset(), so once the peak usage is
+	// known the allocator stops touching the heap.
+	class CHOPPER_API LinearAllocator {
+	public:
+		static constexpr size_t DefaultBlockSize = 64 * 1024;
+
+		LinearAllocator(size_t blockSize = DefaultBlockSize);
+		~LinearAllocator();
+
+		LinearAllocator(const LinearAllocator&) = delete;
+		LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		// Uninitialized storage for `count` objects
+		template<typename T>
+		T* AllocateArray(size_t count) { return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T))); }
+
+		// Destructors are never run, only trivially destructible types are accepted
+		template<typename T, typename... Args>
+		T* New(Args&&... args);
+
+		void Reset();
+		// Frees every block, the next allocation starts over with a single block
+		void Release();
+
+		// Takes effect on the next block created
+		inline void SetBlockSize(size_t blockSize) { m_BlockSize = blockSize; }
+
+		inline size_t GetUsedSize() const { return m_UsedSize; }
+		inline size_t GetPeakSize() const { return std::max(m_PeakSize, m_UsedSize); }
+		inline size_t GetCapacity() const { return m_Capacity; }
+
+	private:
+		struct Block {
+			Block* Next;
+			size_t Size;
+		};
+
+		Block* CreateBlock(size_t size);
+		static inline unsigned char* GetData(Block* block) { return reinterpret_cast<unsigned char*>(block + 1); }
+
+		Block* m_Head = nullptr;
+		Block* m_Current = nullptr;
+		size_t m_Offset = 0;
+
+		size_t m_BlockSize;
+		size_t m_UsedSize = 0;
+		size_t m_PeakSize = 0;
+		size_t m_Capacity = 0;
+	};
+
+	template<typename T, typename... Args>
+	T* LinearAllocator::New(Args&&... args) {
+		static_assert(std::is_trivially_destructible<T>::value, "LinearAllocator never runs destructors!");
+		return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+
+	// Standard library allocator on top of a LinearAllocator. Deallocation is a no-op, so
+	// containers should reserve() up front rather than grow.
+	template<typename T>
+	class ArenaAllocator {
+	public:
+		using value_type = T;
+
+		ArenaAllocator(LinearAllocator& arena) noexcept : m_Arena(&arena) {}
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_Arena(other.GetArena()) {}
+
+		T* allocate(size_t count) { return m_Arena->AllocateArray<T>(count); }
+		void deallocate(T*, size_t) noexcept {}
+
+		inline LinearAllocator* GetArena() const { return m_Arena; }
+
+	private:
+		LinearAllocator* m_Arena;
+	};
+
+	template<typename T, typename U>
+	inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.GetArena() == b.GetArena(); }
+	template<typename T, typename U>
+	inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.GetArena() != b.GetArena(); }
+
+	template<typename T>
+	using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}
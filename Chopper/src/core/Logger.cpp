@@ -6,10 +6,34 @@ namespace Chopper {
 
 	std::shared_ptr<spdlog::logger> Logger::s_Logger;
 
-	void Logger::Init() {
+	void Logger::Init(const LoggerSettings& settings) {
 		spdlog::set_pattern("%^[%m-%d-%C %T.%e] %n (%l): %v%$");
-		s_Logger = spdlog::stdout_color_mt("CHOPPER");
+		if (settings.Async) {
+			auto sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+			s_Logger = std::make_shared<AsyncLogger>("CHOPPER", spdlog::sinks_init_list{ sink }, settings.QueueCapacity, settings.OverflowPolicy);
+			spdlog::initialize_logger(s_Logger);
+			// Errors are written before returning, an assertion may break right after logging
+			s_Logger->flush_on(spdlog::level::err);
+		}
+		else {
+			s_Logger = spdlog::stdout_color_mt("CHOPPER");
+		}
 		s_Logger->set_level(spdlog::level::trace);
 	}
 
+	void Logger::Shutdown() {
+		if (!s_Logger)
+			return;
+
+		s_Logger->flush();
+		spdlog::drop(s_Logger->name());
+		s_Logger.reset();
+	}
+
+	AsyncLogStats Logger::GetAsyncStats() {
+		if (auto asyncLogger = std::dynamic_pointer_cast<AsyncLogger>(s_Logger))
+			return asyncLogger->GetStats();
+		return {};
+	}
+
 }
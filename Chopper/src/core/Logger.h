@@ -6,11 +6,25 @@
 #include <common/definitions.h>
 #include <common/includes.h>
 
+#include "AsyncLogger.h"
+
 namespace Chopper {
+
+	struct LoggerSettings {
+		// Formats on the calling thread but writes to the sinks from a background thread
+		bool Async = false;
+		uint32_t QueueCapacity = 8192;
+		LogOverflowPolicy OverflowPolicy = LogOverflowPolicy::Block;
+	};
 	
 	class CHOPPER_API Logger {
 	public:
-		static void Init();
+		static void Init(const LoggerSettings& settings = {});
+		// Writes out every queued message and stops the async worker
+		static void Shutdown();
+
+		// All zero in synchronous mode
+		static AsyncLogStats GetAsyncStats();
 
 		inline static std::shared_ptr<spdlog::logger>& GetLogger() { return s_Logger; }
 
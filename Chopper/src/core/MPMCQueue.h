@@ -0,0 +1,104 @@
+#pragma once
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+namespace Chopper {
+
+	// Bounded lock-free queue for any number of producers and consumers.
+	// Every slot carries a sequence number (Vyukov's bounded queue), so producers and consumers
+	// only contend on their own index and never block each other while copying a value.
+	template<typename T>
+	class MPMCQueue {
+		static_assert(std::is_trivially_copyable_v<T>, "MPMCQueue only holds trivially copyable values");
+	public:
+		// Capacity is rounded up to a power of two
+		explicit MPMCQueue(uint32_t capacity) {
+			uint32_t size = 2;
+			while (size < capacity)
+				size <<= 1;
+
+			m_Mask = size - 1;
+			m_Slots = std::make_unique<Slot[]>(size);
+			for (uint32_t i = 0; i < size; ++i)
+				m_Slots[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+
+		MPMCQueue(const MPMCQueue&) = delete;
+		MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+		// Safe from any thread, returns false when the queue is full
+		bool Push(const T& value) {
+			uint32_t position = m_Tail.load(std::memory_order_relaxed);
+			for (;;) {
+				Slot& slot = m_Slots[position & m_Mask];
+				uint32_t sequence = slot.Sequence.load(std::memory_order_acquire);
+				int32_t difference = static_cast<int32_t>(sequence - position);
+
+				if (difference == 0) {
+					if (m_Tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (difference < 0) {
+					return false;
+				}
+				else {
+					position = m_Tail.load(std::memory_order_relaxed);
+				}
+			}
+
+			Slot& slot = m_Slots[position & m_Mask];
+			slot.Value = value;
+			slot.Sequence.store(position + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Safe from any thread, returns false when the queue is empty
+		bool Pop(T& value) {
+			uint32_t position = m_Head.load(std::memory_order_relaxed);
+			for (;;) {
+				Slot& slot = m_Slots[position & m_Mask];
+				uint32_t sequence = slot.Sequence.load(std::memory_order_acquire);
+				int32_t difference = static_cast<int32_t>(sequence - (position + 1));
+
+				if (difference == 0) {
+					if (m_Head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (difference < 0) {
+					return false;
+				}
+				else {
+					position = m_Head.load(std::memory_order_relaxed);
+				}
+			}
+
+			Slot& slot = m_Slots[position & m_Mask];
+			value = slot.Value;
+			slot.Sequence.store(position + m_Mask + 1, std::memory_order_release);
+			return true;
+		}
+
+		inline uint32_t GetCapacity() const { return m_Mask + 1; }
+
+		// Approximate while other threads push or pop
+		inline uint32_t GetSize() const { return m_Tail.load(std::memory_order_relaxed) - m_Head.load(std::memory_order_relaxed); }
+
+	private:
+		struct Slot {
+			std::atomic<uint32_t> Sequence;
+			T Value;
+		};
+
+		std::unique_ptr<Slot[]> m_Slots;
+		uint32_t m_Mask = 0;
+
+		alignas(64) std::atomic<uint32_t> m_Tail{ 0 };
+		alignas(64) std::atomic<uint32_t> m_Head{ 0 };
+	};
+
+}
@@ -0,0 +1,249 @@
+#include "Profiler.h"
+
+#include "Logger.h"
+
+#include <fstream>
+#include <mutex>
+
+namespace Chopper {
+
+	static constexpr uint32_t s_ThreadBufferCapacity = 1u << 16;
+
+	struct ThreadProfileBuffer {
+		std::unique_ptr<ProfileEvent[]> Events;
+		// Written by the owning thread only, read by the exporter once the capture stopped
+		std::atomic<uint32_t> Count{ 0 };
+		std::atomic<uint32_t> Generation{ 0 };
+		std::atomic<uint64_t> Dropped{ 0 };
+		uint32_t ThreadIndex = 0;
+		std::string Name;
+		bool InUse = false;
+		bool Gpu = false;
+	};
+
+	std::atomic<bool> Profiler::s_Capturing{ false };
+
+	static std::atomic<uint32_t> s_Generation{ 0 };
+
+	static std::mutex s_BufferMutex;
+	static std::vector<std::unique_ptr<ThreadProfileBuffer>> s_Buffers;
+
+	static std::mutex s_RequestMutex;
+	static bool s_CaptureRequested = false;
+	static bool s_RelativeRequest = false;
+	static uint64_t s_FirstFrame = 0;
+	static uint64_t s_LastFrame = 0;
+	static std::string s_CapturePath;
+	static uint64_t s_CaptureStart = 0;
+
+	// Returns the buffer to the pool when its thread exits
+	struct ThreadProfileBufferHandle {
+		ThreadProfileBuffer* Buffer = nullptr;
+
+		~ThreadProfileBufferHandle() {
+			if (!Buffer)
+				return;
+			std::lock_guard<std::mutex> lock(s_BufferMutex);
+			Buffer->InUse = false;
+		}
+	};
+
+	static thread_local ThreadProfileBufferHandle s_ThreadBuffer;
+
+	static ThreadProfileBuffer& GetThreadBuffer() {
+		if (s_ThreadBuffer.Buffer)
+			return *s_ThreadBuffer.Buffer;
+
+		std::lock_guard<std::mutex> lock(s_BufferMutex);
+		uint32_t generation = s_Generation.load(std::memory_order_acquire);
+		for (auto& buffer : s_Buffers) {
+			// A buffer still holding events of the running capture must not be overwritten
+			if (!buffer->InUse && buffer->Generation.load(std::memory_order_relaxed) != generation) {
+				buffer->InUse = true;
+				buffer->Name.clear();
+				s_ThreadBuffer.Buffer = buffer.get();
+				return *buffer;
+			}
+		}
+
+		auto buffer = std::make_unique<ThreadProfileBuffer>();
+		buffer->Events = std::make_unique<ProfileEvent[]>(s_ThreadBufferCapacity);
+		buffer->ThreadIndex = static_cast<uint32_t>(s_Buffers.size());
+		buffer->InUse = true;
+		s_ThreadBuffer.Buffer = buffer.get();
+		s_Buffers.emplace_back(std::move(buffer));
+		return *s_ThreadBuffer.Buffer;
+	}
+
+	void Profiler::RequestCapture(uint64_t firstFrame, uint32_t frameCount, const std::string& path) {
+		std::lock_guard<std::mutex> lock(s_RequestMutex);
+		s_CaptureRequested = true;
+		s_RelativeRequest = false;
+		s_FirstFrame = firstFrame;
+		s_LastFrame = firstFrame + std::max(frameCount, 1u);
+		s_CapturePath = path;
+	}
+
+	void Profiler::RequestCapture(uint32_t frameCount, const std::string& path) {
+		RequestCapture(0, frameCount, path);
+		std::lock_guard<std::mutex> lock(s_RequestMutex);
+		s_RelativeRequest = true;
+	}
+
+	void Profiler::OnFrameStart(uint64_t frameIndex) {
+		std::lock_guard<std::mutex> lock(s_RequestMutex);
+		if (!s_CaptureRequested)
+			return;
+
+		if (IsCapturing()) {
+			if (frameIndex >= s_LastFrame) {
+				FinishCapture();
+				s_CaptureRequested = false;
+			}
+			return;
+		}
+
+		if (s_RelativeRequest) {
+			s_LastFrame = frameIndex + (s_LastFrame - s_FirstFrame);
+			s_FirstFrame = frameIndex;
+			s_RelativeRequest = false;
+		}
+		if (frameIndex >= s_FirstFrame)
+			StartCapture();
+	}
+
+	void Profiler::StartCapture() {
+		s_Generation.fetch_add(1, std::memory_order_acq_rel);
+		s_CaptureStart = FrameClock::Now();
+		s_Capturing.store(true, std::memory_order_release);
+		CHOPPER_LOG_INFO("Profiler capture started.");
+	}
+
+	void Profiler::FinishCapture() {
+		s_Capturing.store(false, std::memory_order_release);
+		if (ExportChromeTrace(s_CapturePath))
+			CHOPPER_LOG_INFO("Profiler capture written to {}.", s_CapturePath);
+	}
+
+	void Profiler::SetThreadName(const char* name) {
+		ThreadProfileBuffer& buffer = GetThreadBuffer();
+		std::lock_guard<std::mutex> lock(s_BufferMutex);
+		buffer.Name = name;
+	}
+
+	static void AppendEvent(ThreadProfileBuffer& buffer, const char* name, uint64_t start, uint64_t end) {
+		uint32_t generation = s_Generation.load(std::memory_order_acquire);
+		if (buffer.Generation.load(std::memory_order_relaxed) != generation) {
+			buffer.Count.store(0, std::memory_order_relaxed);
+			buffer.Dropped.store(0, std::memory_order_relaxed);
+			buffer.Generation.store(generation, std::memory_order_release);
+		}
+
+		uint32_t count = buffer.Count.load(std::memory_order_relaxed);
+		if (count >= s_ThreadBufferCapacity) {
+			buffer.Dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		buffer.Events[count] = { name, start, end };
+		buffer.Count.store(count + 1, std::memory_order_release);
+	}
+
+	void Profiler::Record(const char* name, uint64_t start, uint64_t end) {
+		AppendEvent(GetThreadBuffer(), name, start, end);
+	}
+
+	void Profiler::RecordGpu(const char* name, uint64_t start, uint64_t end) {
+		static ThreadProfileBuffer* s_GpuBuffer = nullptr;
+		if (!s_GpuBuffer) {
+			std::lock_guard<std::mutex> lock(s_BufferMutex);
+			auto buffer = std::make_unique<ThreadProfileBuffer>();
+			buffer->Events = std::make_unique<ProfileEvent[]>(s_ThreadBufferCapacity);
+			buffer->ThreadIndex = static_cast<uint32_t>(s_Buffers.size());
+			buffer->Name = "GPU";
+			buffer->Gpu = true;
+			// Never handed out to a thread
+			buffer->InUse = true;
+			s_GpuBuffer = buffer.get();
+			s_Buffers.emplace_back(std::move(buffer));
+		}
+		AppendEvent(*s_GpuBuffer, name, start, end);
+	}
+
+	uint64_t Profiler::GetDroppedCount() {
+		std::lock_guard<std::mutex> lock(s_BufferMutex);
+		uint32_t generation = s_Generation.load(std::memory_order_acquire);
+		uint64_t dropped = 0;
+		for (auto& buffer : s_Buffers) {
+			if (buffer->Generation.load(std::memory_order_acquire) == generation)
+				dropped += buffer->Dropped.load(std::memory_order_relaxed);
+		}
+		return dropped;
+	}
+
+	static void WriteJsonString(std::ofstream& file, const char* string) {
+		file << '"';
+		for (const char* c = string; *c; ++c) {
+			if (*c == '"' || *c == '\\')
+				file << '\\';
+			if (static_cast<unsigned char>(*c) >= 0x20)
+				file << *c;
+		}
+		file << '"';
+	}
+
+	bool Profiler::ExportChromeTrace(const std::string& path) {
+		std::ofstream file(path, std::ios::trunc);
+		if (!file.is_open()) {
+			CHOPPER_LOG_ERROR("Could not open profiler capture file {}.", path);
+			return false;
+		}
+
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		file.setf(std::ios::fixed);
+		file.precision(3);
+
+		bool first = true;
+		uint64_t eventCount = 0;
+		uint32_t generation = s_Generation.load(std::memory_order_acquire);
+
+		std::lock_guard<std::mutex> lock(s_BufferMutex);
+		for (auto& buffer : s_Buffers) {
+			if (buffer->Generation.load(std::memory_order_acquire) != generation)
+				continue;
+
+			if (!buffer->Name.empty()) {
+				file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->ThreadIndex << ",\"args\":{\"name\":";
+				WriteJsonString(file, buffer->Name.c_str());
+				file << "}}";
+				first = false;
+			}
+
+			uint32_t count = buffer->Count.load(std::memory_order_acquire);
+			for (uint32_t i = 0; i < count; ++i) {
+				const ProfileEvent& event = buffer->Events[i];
+				// Opened during the previous capture
+				if (event.Start < s_CaptureStart)
+					continue;
+
+				double start = static_cast<double>(event.Start - s_CaptureStart) * 1e-3;
+				double duration = static_cast<double>(event.End - event.Start) * 1e-3;
+
+				file << (first ? "" : ",") << "\n{\"name\":";
+				WriteJsonString(file, event.Name);
+				file << ",\"cat\":" << (buffer->Gpu ? "\"gpu\"" : "\"cpu\"") << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->ThreadIndex
+					<< ",\"ts\":" << start << ",\"dur\":" << duration << "}";
+				first = false;
+			}
+			eventCount += count;
+
+			if (uint64_t dropped = buffer->Dropped.load(std::memory_order_relaxed))
+				CHOPPER_LOG_WARN("Profiler dropped {} events on thread {}, its buffer was full.", dropped, buffer->ThreadIndex);
+		}
+
+		file << "\n]}\n";
+		CHOPPER_LOG_DEBUG("Profiler exported {} events.", eventCount);
+		return file.good();
+	}
+
+}
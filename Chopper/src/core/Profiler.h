@@ -0,0 +1,85 @@
+#pragma once
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+#include "FrameClock.h"
+
+#include <atomic>
+
+namespace Chopper {
+
+	struct ProfileEvent {
+		// Must outlive the capture, scope names are string literals
+		const char* Name;
+		uint64_t Start;
+		uint64_t End;
+	};
+
+	// Scoped CPU profiler. Threads append completed scopes to their own buffer without locking,
+	// a capture covers a range of frames and is exported as a Chrome Trace Event JSON file
+	// (chrome://tracing, Perfetto).
+	class CHOPPER_API Profiler {
+	public:
+		// Captures frames [firstFrame, firstFrame + frameCount) and writes the trace once the last one ended
+		static void RequestCapture(uint64_t firstFrame, uint32_t frameCount, const std::string& path);
+		// Captures the next frameCount frames
+		static void RequestCapture(uint32_t frameCount, const std::string& path);
+
+		// Called by the application at the start of every frame, starts and finishes captures
+		static void OnFrameStart(uint64_t frameIndex);
+
+		inline static bool IsCapturing() { return s_Capturing.load(std::memory_order_relaxed); }
+
+		static void SetThreadName(const char* name);
+		static void Record(const char* name, uint64_t start, uint64_t end);
+		// Appends to the "GPU" track, only the render thread may call it
+		static void RecordGpu(const char* name, uint64_t start, uint64_t end);
+
+		// Events dropped because a thread buffer was full during the last capture
+		static uint64_t GetDroppedCount();
+
+	private:
+		static void StartCapture();
+		static void FinishCapture();
+		static bool ExportChromeTrace(const std::string& path);
+
+		static std::atomic<bool> s_Capturing;
+	};
+
+	class ProfileScope {
+	public:
+		ProfileScope(const char* name);
+		~ProfileScope();
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		const char* m_Name;
+		uint64_t m_Start;
+	};
+
+	inline ProfileScope::ProfileScope(const char* name)
+		: m_Name(name), m_Start(Profiler::IsCapturing() ? FrameClock::Now() : 0) {}
+
+	inline ProfileScope::~ProfileScope() {
+		if (m_Start)
+			Profiler::Record(m_Name, m_Start, FrameClock::Now());
+	}
+
+}
+
+#ifdef CHOPPER_PROFILING_ENABLED
+#define CHOPPER_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CHOPPER_PROFILE_CONCAT(a, b) CHOPPER_PROFILE_CONCAT_IMPL(a, b)
+#define CHOPPER_PROFILE_SCOPE(name) ::Chopper::ProfileScope CHOPPER_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define CHOPPER_PROFILE_FUNCTION() CHOPPER_PROFILE_SCOPE(__FUNCTION__)
+#define CHOPPER_PROFILE_THREAD(name) ::Chopper::Profiler::SetThreadName(name)
+#define CHOPPER_PROFILE_FRAME(frameIndex) ::Chopper::Profiler::OnFrameStart(frameIndex)
+#else
+#define CHOPPER_PROFILE_SCOPE(name)
+#define CHOPPER_PROFILE_FUNCTION()
+#define CHOPPER_PROFILE_THREAD(name)
+#define CHOPPER_PROFILE_FRAME(frameIndex)
+#endif
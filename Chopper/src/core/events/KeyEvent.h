@@ -12,8 +12,8 @@ namespace Chopper {
 		inline KeyCode GetKeyCode() const { return m_KeyCode; }
 
 	protected:
-		KeyEvent(KeyCode keycode, std::string name)
-			: m_KeyCode(keycode), Event(name) {}
+		KeyEvent(EventType type, KeyCode keycode)
+			: Event(type), m_KeyCode(keycode) {}
 
 		KeyCode m_KeyCode;
 	};
@@ -21,16 +21,16 @@ namespace Chopper {
 	class CHOPPER_API KeyPressedEvent : public KeyEvent {
 	public:
 		KeyPressedEvent(KeyCode keycode, int repeatcount)
-			: m_RepeatCount(repeatcount), KeyEvent(keycode, "KeyPressed") {}
+			: KeyEvent(GetStaticType(), keycode), m_RepeatCount(repeatcount) {}
 
 		inline int GetRepeatCount() const { return m_RepeatCount; }
 
-		static EventType GetStaticType() { return EventType::KeyPressed; }
-		EventType GetEventType() const override { return GetStaticType(); }
+		static constexpr EventType GetStaticType() { return EventType::KeyPressed; }
+		static constexpr std::string_view GetStaticName() { return "KeyPressed"; }
 
-		std::string GetStateLog() const override {
+		std::string GetStateLog() const {
 			std::stringstream ss;
-			ss << m_Name << ": " << static_cast<int>(m_KeyCode) << " (" << m_RepeatCount << ")";
+			ss << GetStaticName() << ": " << static_cast<int>(m_KeyCode) << " (" << m_RepeatCount << ")";
 			return ss.str();
 		}
 
@@ -41,15 +41,18 @@ namespace Chopper {
 	class CHOPPER_API KeyReleasedEvent : public KeyEvent {
 	public:
 		KeyReleasedEvent(KeyCode keycode)
-			: KeyEvent(keycode, "KeyReleased") {}
+			: KeyEvent(GetStaticType(), keycode) {}
 
-		static EventType GetStaticType() { return EventType::KeyReleased; }
-		EventType GetEventType() const override { return GetStaticType(); }
+		static constexpr EventType GetStaticType() { return EventType::KeyReleased; }
+		static constexpr std::string_view GetStaticName() { return "KeyReleased"; }
 
-		std::string GetStateLog() const override {
+		std::string GetStateLog() const {
 			std::stringstream ss;
-			ss << m_Name << ": " << static_cast<int>(m_KeyCode);
+			ss << GetStaticName() << ": " << static_cast<int>(m_KeyCode);
 			return ss.str();
 		}
 	};
+
+	static_assert(std::is_trivially_copyable_v<KeyPressedEvent>, "Events must stay trivially copyable");
+	static_assert(std::is_trivially_copyable_v<KeyReleasedEvent>, "Events must stay trivially copyable");
 }
@@ -11,15 +11,15 @@ namespace Chopper {
 	public:
 		inline MouseButtonCode GetMouseButton() const { return m_MouseButton; }
 
-		std::string GetStateLog() const override {
+		std::string GetStateLog() const {
 			std::stringstream ss;
-			ss << m_Name << ": " << static_cast<int>(m_MouseButton);
+			ss << GetName() << ": " << static_cast<int>(m_MouseButton);
 			return ss.str();
 		}
 
 	protected:
-		MouseButtonEvent(MouseButtonCode button, std::string name)
-			: m_MouseButton(button), Event(name) {}
+		MouseButtonEvent(EventType type, MouseButtonCode button)
+			: Event(type), m_MouseButton(button) {}
 
 		MouseButtonCode m_MouseButton;
 	};
@@ -27,19 +27,19 @@ namespace Chopper {
 	class CHOPPER_API MouseButtonPressedEvent : public MouseButtonEvent {
 	public:
 		MouseButtonPressedEvent(MouseButtonCode button)
-			: MouseButtonEvent(button, "MouseButtonPressed") {}
+			: MouseButtonEvent(GetStaticType(), button) {}
 
-		static EventType GetStaticType() { return EventType::MouseButtonPressed; }
-		EventType GetEventType() const override { return GetStaticType(); }
+		static constexpr EventType GetStaticType() { return EventType::MouseButtonPressed; }
+		static constexpr std::string_view GetStaticName() { return "MouseButtonPressed"; }
 	};
 
 	class CHOPPER_API MouseButtonReleasedEvent : public MouseButtonEvent {
 	public:
 		MouseButtonReleasedEvent(MouseButtonCode button)
-			: MouseButtonEvent(button, "MouseButtonReleased") {}
+			: MouseButtonEvent(GetStaticType(), button) {}
 
-		static EventType GetStaticType() { return EventType::MouseButtonReleased; }
-		EventType GetEventType() const override { return GetStaticType(); }
+		static constexpr EventType GetStaticType() { return EventType::MouseButtonReleased; }
+		static constexpr std::string_view GetStaticName() { return "MouseButtonReleased"; }
 	};
 
 
@@ -47,17 +47,17 @@ namespace Chopper {
 	class CHOPPER_API MouseMovedEvent : public Event {
 	public:
 		MouseMovedEvent(float x, float y)
-			: m_MouseX(x), m_MouseY(y), Event("MouseMoved") {}
+			: Event(GetStaticType()), m_MouseX(x), m_MouseY(y) {}
 
 		inline float GetX() const { return m_MouseX; }
 		inline float GetY() const { return m_MouseY; }
 
-		static EventType GetStaticType() { return EventType::MouseMoved; }
-		EventType GetEventType() const override { return GetStaticType(); }
+		static constexpr EventType GetStaticType() { return EventType::MouseMoved; }
+		static constexpr std::string_view GetStaticName() { return "MouseMoved"; }
 
-		std::string GetStateLog() const override {
+		std::string GetStateLog() const {
 			std::stringstream ss;
-			ss << m_Name << ": (" << m_MouseX << ", " << m_MouseY << ")";
+			ss << GetStaticName() << ": (" << m_MouseX << ", " << m_MouseY << ")";
 			return ss.str();
 		}
 
@@ -68,17 +68,17 @@ namespace Chopper {
 	class CHOPPER_API MouseWheelEvent : public Event {
 	public:
 		MouseWheelEvent(float xOffset, float yOffset)
-			: m_XOffset(xOffset), m_YOffset(yOffset), Event("MouseWheel") {}
+			: Event(GetStaticType()), m_XOffset(xOffset), m_YOffset(yOffset) {}
 
 		inline float GetXOffset() const { return m_XOffset; }
 		inline float GetYOffset() const { return m_YOffset; }
 
-		static EventType GetStaticType() { return EventType::MouseWheel; }
-		EventType GetEventType() const override { return GetStaticType(); }
+		static constexpr EventType GetStaticType() { return EventType::MouseWheel; }
+		static constexpr std::string_view GetStaticName() { return "MouseWheel"; }
 
-		std::string GetStateLog() const override {
+		std::string GetStateLog() const {
 			std::stringstream ss;
-			ss << m_Name << ": (" << m_XOffset << ", " << m_YOffset << ")";
+			ss << GetStaticName() << ": (" << m_XOffset << ", " << m_YOffset << ")";
 			return ss.str();
 		}
 
@@ -86,4 +86,9 @@ namespace Chopper {
 		float m_XOffset, m_YOffset;
 	};
 
+	static_assert(std::is_trivially_copyable_v<MouseButtonPressedEvent>, "Events must stay trivially copyable");
+	static_assert(std::is_trivially_copyable_v<MouseButtonReleasedEvent>, "Events must stay trivially copyable");
+	static_assert(std::is_trivially_copyable_v<MouseMovedEvent>, "Events must stay trivially copyable");
+	static_assert(std::is_trivially_copyable_v<MouseWheelEvent>, "Events must stay trivially copyable");
+
 }
@@ -9,26 +9,26 @@ namespace Chopper {
 	class CHOPPER_API WindowCloseEvent : public Event {
 	public:
 		WindowCloseEvent()
-			: Event("WindowClose") {}
+			: Event(GetStaticType()) {}
 
-		static EventType GetStaticType() { return EventType::WindowClose; }
-		EventType GetEventType() const override { return GetStaticType(); }
+		static constexpr EventType GetStaticType() { return EventType::WindowClose; }
+		static constexpr std::string_view GetStaticName() { return "WindowClose"; }
 	};
 
 	class CHOPPER_API WindowResizeEvent : public Event {
 	public:
 		WindowResizeEvent(uint32_t width, uint32_t height)
-			: m_Width(width), m_Height(height), Event("WindowResize") {}
+			: Event(GetStaticType()), m_Width(width), m_Height(height) {}
 
 		inline uint32_t GetWidth() const { return m_Width; }
 		inline uint32_t GetHeight() const { return m_Height; }
 
-		static EventType GetStaticType() { return EventType::WindowResize; }
-		EventType GetEventType() const override { return GetStaticType(); }
+		static constexpr EventType GetStaticType() { return EventType::WindowResize; }
+		static constexpr std::string_view GetStaticName() { return "WindowResize"; }
 
-		std::string GetStateLog() const override {
+		std::string GetStateLog() const {
 			std::stringstream ss;
-			ss << m_Name << ": (" << m_Width << ", " << m_Height << ")";
+			ss << GetStaticName() << ": (" << m_Width << ", " << m_Height << ")";
 			return ss.str();
 		}
 
@@ -36,4 +36,7 @@ namespace Chopper {
 		uint32_t m_Width, m_Height;
 	};
 
+	static_assert(std::is_trivially_copyable_v<WindowCloseEvent>, "Events must stay trivially copyable");
+	static_assert(std::is_trivially_copyable_v<WindowResizeEvent>, "Events must stay trivially copyable");
+
 }
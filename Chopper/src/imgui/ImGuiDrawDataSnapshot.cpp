@@ -0,0 +1,59 @@
+#include "ImGuiDrawDataSnapshot.h"
+
+#include <imgui.h>
+
+namespace Chopper {
+
+	ImGuiDrawDataSnapshot::ImGuiDrawDataSnapshot() {
+		m_DrawData = IM_NEW(ImDrawData)();
+	}
+
+	ImGuiDrawDataSnapshot::~ImGuiDrawDataSnapshot() {
+		for (ImDrawList* drawList : m_DrawLists)
+			IM_DELETE(drawList);
+		m_DrawLists.clear();
+
+		IM_DELETE(m_DrawData);
+		m_DrawData = nullptr;
+	}
+
+	void ImGuiDrawDataSnapshot::Capture(ImDrawData* source) {
+		ImDrawData& dst = *m_DrawData;
+
+		dst.Valid = source->Valid;
+		dst.CmdListsCount = source->CmdListsCount;
+		dst.TotalIdxCount = source->TotalIdxCount;
+		dst.TotalVtxCount = source->TotalVtxCount;
+		dst.DisplayPos = source->DisplayPos;
+		dst.DisplaySize = source->DisplaySize;
+		dst.FramebufferScale = source->FramebufferScale;
+		dst.OwnerViewport = source->OwnerViewport;
+
+		while (m_DrawLists.size() < static_cast<size_t>(source->CmdListsCount))
+			m_DrawLists.push_back(IM_NEW(ImDrawList)(source->CmdLists[0]->_Data));
+
+		for (int i = 0; i < source->CmdListsCount; ++i) {
+			ImDrawList* srcList = source->CmdLists[i];
+			ImDrawList* dstList = m_DrawLists[i];
+
+			// ImGui clears its lists on the next NewFrame() but keeps their capacity
+			dstList->CmdBuffer.swap(srcList->CmdBuffer);
+			dstList->IdxBuffer.swap(srcList->IdxBuffer);
+			dstList->VtxBuffer.swap(srcList->VtxBuffer);
+			dstList->Flags = srcList->Flags;
+		}
+
+#if IMGUI_VERSION_NUM >= 18980
+		dst.CmdLists.resize(source->CmdListsCount);
+		for (int i = 0; i < source->CmdListsCount; ++i)
+			dst.CmdLists[i] = m_DrawLists[i];
+#else
+		dst.CmdLists = m_DrawLists.data();
+#endif
+	}
+
+	void ImGuiDrawDataSnapshot::Clear() {
+		m_DrawData->Clear();
+	}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+struct ImDrawData;
+struct ImDrawList;
+
+namespace Chopper {
+
+	// Owns a copy of ImGui's draw data that stays valid after the next ImGui::NewFrame().
+	// Buffers are swapped with ImGui's draw lists instead of copied, so once capacities
+	// settle capturing a frame does not allocate.
+	class ImGuiDrawDataSnapshot {
+	public:
+		ImGuiDrawDataSnapshot();
+		~ImGuiDrawDataSnapshot();
+
+		ImGuiDrawDataSnapshot(const ImGuiDrawDataSnapshot&) = delete;
+		ImGuiDrawDataSnapshot& operator=(const ImGuiDrawDataSnapshot&) = delete;
+
+		void Capture(ImDrawData* source);
+		void Clear();
+
+		inline ImDrawData* GetDrawData() const { return m_DrawData; }
+
+	private:
+		ImDrawData* m_DrawData = nullptr;
+		std::vector<ImDrawList*> m_DrawLists;
+	};
+
+}
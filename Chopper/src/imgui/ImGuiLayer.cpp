@@ -5,6 +5,8 @@
 #include <imgui_impl_vulkan.h>
 
 #include <core/Application.h>
+#include <core/Profiler.h>
+#include <core/AllocationTracker.h>
 
 #define GLFW_INCLUDE_NONE
 #define GLFW_INCLUDE_VULKAN
@@ -12,9 +14,11 @@
 #include <vulkan/vulkan.hpp>
 
 #include <renderer/vulkan/VulkanContext.h>
+#include <renderer/vulkan/VulkanDebugMessages.h>
 #include <renderer/Renderer.h>
 
 #include <stdlib.h>
+#include <numeric>
 
 namespace Chopper {
 
@@ -115,6 +119,7 @@ namespace Chopper {
 
 	void ImGuiLayer::OnDetach() {
 		// Cleanup
+		Renderer::StopRenderThread();
 		vkDeviceWaitIdle(VulkanContext::GetDevice()->Logical());
 
 		ImGui_ImplVulkan_Shutdown();
@@ -124,12 +129,102 @@ namespace Chopper {
 		Renderer::Shutdown();
 	}
 
+#ifdef DEBUG_BUILD
+	static const char* DebugSeverityName(VkDebugUtilsMessageSeverityFlagBitsEXT severity) {
+		switch (severity) {
+		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT: return "Verbose";
+		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:    return "Info";
+		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT: return "Warning";
+		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:   return "Error";
+		default:                                              return "Unknown";
+		}
+	}
+
+	static void DrawVulkanDebugMessages() {
+		if (!ImGui::Begin("Vulkan Messages")) {
+			ImGui::End();
+			return;
+		}
+
+		// Snapshot and sort order are kept between frames and only rebuilt once new messages came in
+		static std::vector<VulkanDebugMessageStats> s_Snapshot;
+		static std::vector<uint32_t> s_Order;
+		static uint64_t s_SnapshotCount = UINT64_MAX;
+		static std::string s_Tooltip;
+
+		uint64_t totalCount = VulkanDebugMessages::GetTotalCount();
+		if (totalCount != s_SnapshotCount) {
+			s_SnapshotCount = totalCount;
+			VulkanDebugMessages::GetStats(s_Snapshot);
+			s_Order.resize(s_Snapshot.size());
+			std::iota(s_Order.begin(), s_Order.end(), 0u);
+			std::sort(s_Order.begin(), s_Order.end(), [](uint32_t a, uint32_t b) { return s_Snapshot[a].Count > s_Snapshot[b].Count; });
+		}
+
+		ImGui::Text("%llu messages, %llu suppressed repeats", static_cast<unsigned long long>(totalCount),
+			static_cast<unsigned long long>(VulkanDebugMessages::GetSuppressedCount()));
+		ImGui::SameLine();
+		if (ImGui::Button("Reset"))
+			VulkanDebugMessages::Reset();
+
+		uint64_t now = FrameClock::Now();
+		if (ImGui::BeginTable("##VulkanMessages", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY)) {
+			ImGui::TableSetupScrollFreeze(0, 1);
+			ImGui::TableSetupColumn("Message", ImGuiTableColumnFlags_WidthStretch);
+			ImGui::TableSetupColumn("Severity", ImGuiTableColumnFlags_WidthFixed);
+			ImGui::TableSetupColumn("Count", ImGuiTableColumnFlags_WidthFixed);
+			ImGui::TableSetupColumn("Last Seen", ImGuiTableColumnFlags_WidthFixed);
+			ImGui::TableHeadersRow();
+
+			for (uint32_t index : s_Order) {
+				const VulkanDebugMessageStats& message = s_Snapshot[index];
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(message.Name.c_str());
+				if (ImGui::IsItemHovered() && VulkanDebugMessages::CopyMessageText(message.Key, s_Tooltip)) {
+					ImGui::BeginTooltip();
+					ImGui::PushTextWrapPos(ImGui::GetFontSize() * 40.0f);
+					ImGui::TextUnformatted(s_Tooltip.c_str());
+					ImGui::PopTextWrapPos();
+					ImGui::EndTooltip();
+				}
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(DebugSeverityName(message.Severity));
+				ImGui::TableNextColumn();
+				ImGui::Text("%llu", static_cast<unsigned long long>(message.Count));
+				ImGui::TableNextColumn();
+				ImGui::Text("%.1f s ago", FrameClock::ToSeconds(now - message.LastTime));
+			}
+			ImGui::EndTable();
+		}
+
+		ImGui::End();
+	}
+#endif
+
 	void ImGuiLayer::OnImGuiRender() {
+		// Demo and debug windows are not held to the frame's no-allocation guard
+		CHOPPER_SUSPEND_NO_ALLOCATION_SCOPE();
+
 		static bool show = true;
 		ImGui::ShowDemoWindow(&show);
+
+#ifdef DEBUG_BUILD
+		DrawVulkanDebugMessages();
+#endif
+	}
+
+	void ImGuiLayer::SetViewportsEnabled(bool enabled) {
+		ImGuiIO& io = ImGui::GetIO();
+		if (enabled)
+			io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+		else
+			io.ConfigFlags &= ~ImGuiConfigFlags_ViewportsEnable;
 	}
 
 	void ImGuiLayer::Begin() {
+		CHOPPER_PROFILE_FUNCTION();
+
 		// Start the Dear ImGui frame
 		ImGui_ImplVulkan_NewFrame();
 		ImGui_ImplGlfw_NewFrame();
@@ -137,6 +232,8 @@ namespace Chopper {
 	}
 
 	void ImGuiLayer::End() {
+		CHOPPER_PROFILE_FUNCTION();
+
 		ImGuiIO& io = ImGui::GetIO();
 		Application& app = Application::Get();
 		io.DisplaySize = ImVec2(app.GetWindow().GetWidth(), app.GetWindow().GetHeight());
@@ -147,9 +244,16 @@ namespace Chopper {
 		const bool main_is_minimized = (mainDrawData->DisplaySize.x <= 0.0f || mainDrawData->DisplaySize.y <= 0.0f);
 
 		RenderData data{};
-		data.DeltaTime = 0.0f;
+		data.DeltaTime = app.GetFrameClock().GetDeltaTime();
 		data.ImGuiDrawData = mainDrawData;
 
+		if (Renderer::IsRenderThreadEnabled()) {
+			// Platform windows are not available in this mode, see Application::EnableRenderThread()
+			if (!main_is_minimized)
+				Renderer::SubmitFrame(&data);
+			return;
+		}
+
 		bool beginFrameSuccess = false;
 		if (!main_is_minimized)
 			beginFrameSuccess = Renderer::BeginFrame(&data);
@@ -6,7 +6,7 @@ namespace Chopper {
 	
 	class CHOPPER_API ImGuiLayer : public Layer {
 	public:
-		ImGuiLayer() = default;
+		ImGuiLayer() : Layer(EventCategoryNone) {}
 		~ImGuiLayer() = default;
 
 		void OnAttach() override;
@@ -16,6 +16,8 @@ namespace Chopper {
 		void Begin();
 		void End();
 
+		void SetViewportsEnabled(bool enabled);
+
 	private:
 
 	};
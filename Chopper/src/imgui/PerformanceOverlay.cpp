@@ -0,0 +1,112 @@
+#include "PerformanceOverlay.h"
+
+#include <imgui.h>
+
+#include <core/Application.h>
+#include <core/Profiler.h>
+#include <core/AllocationTracker.h>
+#include <core/events/KeyEvent.h>
+
+#include <renderer/Renderer.h>
+
+namespace Chopper {
+
+	static constexpr float s_SummaryRefreshInterval = 0.5f;
+
+	void PerformanceOverlay::OnEvent(Event& e) {
+		EventDispatcher dispatcher(e);
+		dispatcher.Dispatch<KeyPressedEvent>([&](KeyPressedEvent& e) {
+			if (e.GetKeyCode() != m_ToggleKey || e.GetRepeatCount() != 0)
+				return false;
+			m_Visible = !m_Visible;
+			return true;
+		});
+	}
+
+	void PerformanceOverlay::PushSample(const FrameSample& sample) {
+		m_FrameTimes[m_HistoryOffset] = sample.FrameTime * 1000.0f;
+		m_CpuTimes[m_HistoryOffset] = sample.CpuTime * 1000.0f;
+		m_GpuTimes[m_HistoryOffset] = sample.GpuTime * 1000.0f;
+		m_HistoryOffset = (m_HistoryOffset + 1) % HistorySize;
+	}
+
+	void PerformanceOverlay::RefreshSummaries() {
+		const FrameStats& stats = Application::Get().GetFrameStats();
+		m_FrameSummary = stats.GetSummary(FrameMetric::FrameTime);
+		m_CpuSummary = stats.GetSummary(FrameMetric::CpuTime);
+		m_GpuSummary = stats.GetSummary(FrameMetric::GpuTime);
+		m_SummaryAge = 0.0f;
+	}
+
+	void PerformanceOverlay::OnImGuiRender() {
+		CHOPPER_PROFILE_FUNCTION();
+
+		Application& app = Application::Get();
+		const FrameStats& stats = app.GetFrameStats();
+		if (stats.GetSampleCount() == 0)
+			return;
+
+		// Sampled while hidden too, the graphs are complete as soon as the overlay is shown again
+		const FrameSample& sample = stats.GetLatest();
+		PushSample(sample);
+
+		m_SummaryAge += sample.FrameTime;
+		if (!m_Visible)
+			return;
+		if (m_SummaryAge >= s_SummaryRefreshInterval)
+			RefreshSummaries();
+
+		const RendererFrameStats& rendererStats = Renderer::GetFrameStats();
+
+		const ImGuiViewport* viewport = ImGui::GetMainViewport();
+		ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + 10.0f, viewport->WorkPos.y + 10.0f), ImGuiCond_Always);
+		ImGui::SetNextWindowViewport(viewport->ID);
+		ImGui::SetNextWindowBgAlpha(0.6f);
+
+		ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoDocking | ImGuiWindowFlags_AlwaysAutoResize |
+		                         ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+		if (!ImGui::Begin("Performance", nullptr, flags)) {
+			ImGui::End();
+			return;
+		}
+
+		float frameTime = sample.FrameTime * 1000.0f;
+		ImGui::Text("%.1f FPS (%.2f ms)", frameTime > 0.0f ? 1000.0f / frameTime : 0.0f, frameTime);
+		ImGui::Text("p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms", m_FrameSummary.P50 * 1000.0f, m_FrameSummary.P95 * 1000.0f,
+			m_FrameSummary.P99 * 1000.0f, m_FrameSummary.Max * 1000.0f);
+		ImGui::Text("Stutters: %u in window, %llu total", stats.GetStutterCount(), static_cast<unsigned long long>(stats.GetTotalStutterCount()));
+
+		float graphMax = std::max(m_FrameSummary.Max * 1000.0f, 1.0f) * 1.1f;
+		ImVec2 graphSize(260.0f, 50.0f);
+		ImGui::PlotLines("Frame", m_FrameTimes.data(), HistorySize, m_HistoryOffset, nullptr, 0.0f, graphMax, graphSize);
+
+		ImGui::Separator();
+		float cpuTime = sample.CpuTime * 1000.0f;
+		float gpuTime = sample.GpuTime * 1000.0f;
+		ImGui::Text("CPU %.2f ms (p95 %.2f)", cpuTime, m_CpuSummary.P95 * 1000.0f);
+		ImGui::ProgressBar(frameTime > 0.0f ? cpuTime / frameTime : 0.0f, ImVec2(graphSize.x, 0.0f), "");
+		ImGui::Text("GPU %.2f ms (p95 %.2f)", gpuTime, m_GpuSummary.P95 * 1000.0f);
+		ImGui::ProgressBar(frameTime > 0.0f ? gpuTime / frameTime : 0.0f, ImVec2(graphSize.x, 0.0f), "");
+		ImGui::PlotLines("CPU", m_CpuTimes.data(), HistorySize, m_HistoryOffset, nullptr, 0.0f, graphMax, graphSize);
+		ImGui::PlotLines("GPU", m_GpuTimes.data(), HistorySize, m_HistoryOffset, nullptr, 0.0f, graphMax, graphSize);
+		ImGui::Text("Fence %.2f ms  Acquire %.2f ms  Present %.2f ms", sample.FenceWaitTime * 1000.0f,
+			sample.AcquireTime * 1000.0f, sample.PresentTime * 1000.0f);
+
+		ImGui::Separator();
+		ImGui::Text("Present mode: %s", rendererStats.PresentMode);
+		ImGui::Text("Frames in flight: %u%s", rendererStats.FramesInFlight, Renderer::IsRenderThreadEnabled() ? " (render thread)" : "");
+		ImGui::Text("Swapchain recreations: %u", rendererStats.SwapchainRecreations);
+
+		ImGui::Separator();
+		if (AllocationTracker::IsEnabled())
+			ImGui::Text("Heap: %u allocations (%.1f KiB) last frame, %llu guard violations", sample.Allocations,
+				static_cast<double>(sample.AllocatedBytes) / 1024.0, static_cast<unsigned long long>(AllocationTracker::GetGuardViolationCount()));
+		else
+			ImGui::TextUnformatted("Heap: tracking disabled (CHOPPER_TRACK_ALLOCATIONS)");
+		ImGui::Text("Graphics API host: %llu live (%.1f KiB), %llu this frame", static_cast<unsigned long long>(rendererStats.HostLiveAllocations),
+			static_cast<double>(rendererStats.HostLiveBytes) / 1024.0, static_cast<unsigned long long>(rendererStats.HostAllocations));
+
+		ImGui::End();
+	}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <core/Layer.h>
+#include <core/InputCodes.h>
+#include <core/FrameStats.h>
+
+#include <array>
+
+namespace Chopper {
+
+	// Frame time graphs and renderer state drawn in a corner of the main viewport. Samples go
+	// into fixed-size rings, percentiles are refreshed a few times per second.
+	class CHOPPER_API PerformanceOverlay : public Layer {
+	public:
+		static constexpr uint32_t HistorySize = 240;
+
+		PerformanceOverlay() : Layer(EventCategoryKeyboard) {}
+		~PerformanceOverlay() = default;
+
+		void OnImGuiRender() override;
+		void OnEvent(Event& e) override;
+
+		inline void SetVisible(bool visible) { m_Visible = visible; }
+		inline bool IsVisible() const { return m_Visible; }
+		inline void SetToggleKey(KeyCode key) { m_ToggleKey = key; }
+
+	private:
+		void PushSample(const FrameSample& sample);
+		void RefreshSummaries();
+
+		std::array<float, HistorySize> m_FrameTimes{};
+		std::array<float, HistorySize> m_CpuTimes{};
+		std::array<float, HistorySize> m_GpuTimes{};
+		uint32_t m_HistoryOffset = 0;
+
+		FrameMetricSummary m_FrameSummary{};
+		FrameMetricSummary m_CpuSummary{};
+		FrameMetricSummary m_GpuSummary{};
+		float m_SummaryAge = 0.0f;
+
+		KeyCode m_ToggleKey = Key::F3;
+		bool m_Visible = true;
+	};
+
+}
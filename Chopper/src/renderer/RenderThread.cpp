@@ -0,0 +1,110 @@
+#include "RenderThread.h"
+
+#include <core/Logger.h>
+#include <core/Asserts.h>
+#include <core/Profiler.h>
+
+namespace Chopper {
+
+	RenderThread::~RenderThread() {
+		Stop();
+	}
+
+	void RenderThread::Start(RendererBackend* backend, uint32_t framesInFlight) {
+		CHOPPER_ASSERT(!IsRunning(), "Render thread already running!");
+		CHOPPER_ASSERT(framesInFlight > 0, "Render thread needs at least one frame packet!");
+
+		m_Backend = backend;
+		m_Packets.clear();
+		for (uint32_t i = 0; i < framesInFlight; ++i)
+			m_Packets.emplace_back(std::make_unique<FramePacket>());
+
+		m_SubmittedCount = 0;
+		m_CompletedCount = 0;
+		m_StopRequested = false;
+
+		m_Thread = std::thread([this]() { ThreadLoop(); });
+		CHOPPER_LOG_INFO("Render thread started with {} frames in flight.", framesInFlight);
+	}
+
+	void RenderThread::Stop() {
+		if (!IsRunning())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_StopRequested = true;
+		}
+		m_PacketSubmitted.notify_one();
+		m_Thread.join();
+
+		m_Packets.clear();
+		CHOPPER_LOG_INFO("Render thread stopped.");
+	}
+
+	FramePacket& RenderThread::AcquirePacket() {
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_PacketCompleted.wait(lock, [this]() { return m_SubmittedCount - m_CompletedCount < m_Packets.size(); });
+		m_FrameStats = m_LastCompletedStats;
+
+		FramePacket& packet = *m_Packets[m_SubmittedCount % m_Packets.size()];
+		packet.FrameIndex = m_SubmittedCount;
+		packet.Resized = false;
+		packet.Stats = {};
+		return packet;
+	}
+
+	void RenderThread::SubmitPacket() {
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			++m_SubmittedCount;
+		}
+		m_PacketSubmitted.notify_one();
+	}
+
+	void RenderThread::Flush() {
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_PacketCompleted.wait(lock, [this]() { return m_CompletedCount == m_SubmittedCount; });
+	}
+
+	void RenderThread::ThreadLoop() {
+		CHOPPER_PROFILE_THREAD("Render Thread");
+
+		while (true) {
+			FramePacket* packet = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				// Pending packets are still drawn on stop so Flush() semantics hold
+				m_PacketSubmitted.wait(lock, [this]() { return m_StopRequested || m_CompletedCount < m_SubmittedCount; });
+				if (m_CompletedCount == m_SubmittedCount)
+					return;
+				packet = m_Packets[m_CompletedCount % m_Packets.size()].get();
+			}
+
+			RenderPacket(*packet);
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_LastCompletedStats = packet->Stats;
+				++m_CompletedCount;
+			}
+			m_PacketCompleted.notify_all();
+		}
+	}
+
+	void RenderThread::RenderPacket(FramePacket& packet) {
+		CHOPPER_PROFILE_FUNCTION();
+
+		if (packet.Resized)
+			m_Backend->OnResize(packet.FramebufferWidth, packet.FramebufferHeight);
+
+		void* imguiDrawData = packet.ImGuiDrawData.GetDrawData();
+		if (m_Backend->BeginFrame(packet.DeltaTime, imguiDrawData)) {
+			bool result = m_Backend->EndFrame(packet.DeltaTime, imguiDrawData);
+			CHOPPER_ASSERT(result, "Failed to draw frame!");
+		}
+
+		packet.Stats = m_Backend->GetFrameStats();
+	}
+
+}
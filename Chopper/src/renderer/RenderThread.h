@@ -0,0 +1,70 @@
+#pragma once
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+#include "RendererBackend.h"
+
+#include <imgui/ImGuiDrawDataSnapshot.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Chopper {
+
+	// Everything the render thread needs to draw one frame. Written only by the main
+	// thread until submitted, then read only by the render thread until completed.
+	struct FramePacket {
+		uint64_t FrameIndex = 0;
+		float DeltaTime = 0.0f;
+
+		bool Resized = false;
+		uint32_t FramebufferWidth = 0;
+		uint32_t FramebufferHeight = 0;
+
+		ImGuiDrawDataSnapshot ImGuiDrawData;
+
+		RendererFrameStats Stats{};
+	};
+
+	class RenderThread {
+	public:
+		RenderThread() = default;
+		~RenderThread();
+
+		void Start(RendererBackend* backend, uint32_t framesInFlight);
+		void Stop();
+
+		// Blocks while all packets are in flight
+		FramePacket& AcquirePacket();
+		void SubmitPacket();
+		// Blocks until every submitted packet has been rendered
+		void Flush();
+
+		inline bool IsRunning() const { return m_Thread.joinable(); }
+		inline uint32_t GetFramesInFlight() const { return static_cast<uint32_t>(m_Packets.size()); }
+		// Stats of the most recently completed frame, as of the last AcquirePacket()
+		inline const RendererFrameStats& GetFrameStats() const { return m_FrameStats; }
+
+	private:
+		void ThreadLoop();
+		void RenderPacket(FramePacket& packet);
+
+		RendererBackend* m_Backend = nullptr;
+
+		std::thread m_Thread;
+		std::mutex m_Mutex;
+		std::condition_variable m_PacketSubmitted;
+		std::condition_variable m_PacketCompleted;
+
+		std::vector<std::unique_ptr<FramePacket>> m_Packets;
+		uint64_t m_SubmittedCount = 0;
+		uint64_t m_CompletedCount = 0;
+		bool m_StopRequested = false;
+
+		RendererFrameStats m_LastCompletedStats{};
+		RendererFrameStats m_FrameStats{};
+	};
+
+}
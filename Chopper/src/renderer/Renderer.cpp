@@ -4,14 +4,22 @@
 
 #include <core/Logger.h>
 #include <core/Asserts.h>
+#include <core/FrameClock.h>
 
 #include <imgui/ImGuiLayer.h>
 
+#include "RenderThread.h"
 #include "vulkan/VulkanBackend.h"
 
 namespace Chopper {
 
 	RendererBackend* Renderer::s_RenderBackend = nullptr;
+	RenderThread* Renderer::s_RenderThread = nullptr;
+	float Renderer::s_WaitTime = 0.0f;
+
+	bool Renderer::s_ResizePending = false;
+	uint32_t Renderer::s_PendingWidth = 0;
+	uint32_t Renderer::s_PendingHeight = 0;
 
 	bool Renderer::Init(RendererBackendType backendType) {
 		CHOPPER_ASSERT(!s_RenderBackend, "Renderer Backend already initialized!");
@@ -37,6 +45,7 @@ namespace Chopper {
 	}
 
 	void Renderer::Shutdown() {
+		StopRenderThread();
 		delete s_RenderBackend;
 	}
 
@@ -54,15 +63,92 @@ namespace Chopper {
 	}
 
 	bool Renderer::BeginFrame(RenderData* renderData) {
-		return s_RenderBackend->BeginFrame(renderData->DeltaTime, renderData->ImGuiDrawData);
+		bool result = s_RenderBackend->BeginFrame(renderData->DeltaTime, renderData->ImGuiDrawData);
+
+		const RendererFrameStats& stats = s_RenderBackend->GetFrameStats();
+		s_WaitTime += stats.FenceWaitTime + stats.AcquireTime;
+
+		return result;
 	}
 
 	bool Renderer::EndFrame(RenderData* renderData) {
-		return s_RenderBackend->EndFrame(renderData->DeltaTime, renderData->ImGuiDrawData);
+		bool result = s_RenderBackend->EndFrame(renderData->DeltaTime, renderData->ImGuiDrawData);
+
+		s_WaitTime += s_RenderBackend->GetFrameStats().PresentTime;
+
+		return result;
+	}
+
+	void Renderer::StartRenderThread(uint32_t framesInFlight) {
+		CHOPPER_ASSERT(!s_RenderThread, "Render thread already started!");
+		s_RenderThread = new RenderThread();
+		s_RenderThread->Start(s_RenderBackend, framesInFlight);
+	}
+
+	void Renderer::StopRenderThread() {
+		if (!s_RenderThread)
+			return;
+
+		s_RenderThread->Flush();
+		s_RenderThread->Stop();
+		delete s_RenderThread;
+		s_RenderThread = nullptr;
+
+		// Backend is driven from this thread again, apply what the render thread never saw
+		if (s_ResizePending) {
+			s_RenderBackend->OnResize(s_PendingWidth, s_PendingHeight);
+			s_ResizePending = false;
+		}
+	}
+
+	bool Renderer::IsRenderThreadEnabled() {
+		return s_RenderThread != nullptr;
+	}
+
+	void Renderer::SubmitFrame(RenderData* renderData) {
+		CHOPPER_ASSERT(s_RenderThread, "Render thread is not running!");
+
+		uint64_t waitStart = FrameClock::Now();
+		FramePacket& packet = s_RenderThread->AcquirePacket();
+		s_WaitTime += FrameClock::ToSeconds(FrameClock::Now() - waitStart);
+
+		packet.DeltaTime = renderData->DeltaTime;
+		if (s_ResizePending) {
+			packet.Resized = true;
+			packet.FramebufferWidth = s_PendingWidth;
+			packet.FramebufferHeight = s_PendingHeight;
+			s_ResizePending = false;
+		}
+
+		if (renderData->ImGuiDrawData)
+			packet.ImGuiDrawData.Capture(static_cast<ImDrawData*>(renderData->ImGuiDrawData));
+		else
+			packet.ImGuiDrawData.Clear();
+
+		s_RenderThread->SubmitPacket();
 	}
 
 	void Renderer::OnWindowResize(uint32_t width, uint32_t height) {
+		if (s_RenderThread) {
+			// The backend belongs to the render thread, the resize travels with the next packet
+			s_ResizePending = true;
+			s_PendingWidth = width;
+			s_PendingHeight = height;
+			return;
+		}
 		s_RenderBackend->OnResize(width, height);
 	}
 
+	const RendererFrameStats& Renderer::GetFrameStats() {
+		if (s_RenderThread)
+			return s_RenderThread->GetFrameStats();
+		return s_RenderBackend->GetFrameStats();
+	}
+
+	float Renderer::ConsumeWaitTime() {
+		float waitTime = s_WaitTime;
+		s_WaitTime = 0.0f;
+		return waitTime;
+	}
+
 }
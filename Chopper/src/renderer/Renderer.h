@@ -11,6 +11,8 @@ namespace Chopper {
 		void* ImGuiDrawData = nullptr;
 	};
 
+	class RenderThread;
+
 	class Renderer {
 	public:
 		static bool Init(RendererBackendType backendType);
@@ -20,12 +22,28 @@ namespace Chopper {
 		static bool BeginFrame(RenderData* renderData);
 		static bool EndFrame(RenderData* renderData);
 
+		// Render thread mode: the caller hands frames over instead of drawing them
+		static void StartRenderThread(uint32_t framesInFlight = 2);
+		static void StopRenderThread();
+		static bool IsRenderThreadEnabled();
+		static void SubmitFrame(RenderData* renderData);
+
 		static void OnWindowResize(uint32_t width, uint32_t height);
 
+		static const RendererFrameStats& GetFrameStats();
+		// Time the calling thread spent blocked inside the renderer since the last call
+		static float ConsumeWaitTime();
+
 	private:
 		Renderer();
 
 		static RendererBackend* s_RenderBackend;
+		static RenderThread* s_RenderThread;
+		static float s_WaitTime;
+
+		static bool s_ResizePending;
+		static uint32_t s_PendingWidth;
+		static uint32_t s_PendingHeight;
 	};
 
 }
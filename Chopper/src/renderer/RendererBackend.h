@@ -10,6 +10,26 @@ namespace Chopper {
 		RENDERER_OPENGL_BACKEND
 	};
 
+	// Timings of the last frame, in seconds
+	struct RendererFrameStats {
+		float FenceWaitTime = 0.0f;
+		float AcquireTime = 0.0f;
+		float PresentTime = 0.0f;
+		// Resolved frames in flight frames late, 0 when timestamps are not supported
+		float GpuTime = 0.0f;
+
+		// Carried along with the timings so they also reach the main thread in render thread mode
+		uint32_t SwapchainRecreations = 0;
+		uint32_t FramesInFlight = 0;
+		// String literal
+		const char* PresentMode = "";
+
+		// Host memory the graphics API asked the engine for
+		uint64_t HostAllocations = 0;
+		uint64_t HostLiveAllocations = 0;
+		uint64_t HostLiveBytes = 0;
+	};
+
 	class RendererBackend {
 	public:
 		RendererBackend() {}
@@ -20,6 +40,9 @@ namespace Chopper {
 
 		virtual void OnResize(uint32_t width, uint32_t height) = 0;
 
-	private:
+		const RendererFrameStats& GetFrameStats() const { return m_FrameStats; }
+
+	protected:
+		RendererFrameStats m_FrameStats{};
 	};
 }
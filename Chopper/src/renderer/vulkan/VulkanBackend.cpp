@@ -3,11 +3,17 @@
 #include "VulkanBackend.h"
 
 #include "VulkanContext.h"
+#include "VulkanBuffer.h"
+#include "VulkanDebugMessages.h"
+#include "VulkanHostAllocator.h"
 
 #include <common/definitions.h>
 #include <common/includes.h>
 
 #include <core/Logger.h>
+#include <core/FrameClock.h>
+#include <core/Profiler.h>
+#include <core/FrameArena.h>
 #include <core/Application.h> // TODO: Don't think this is a good thing to do
 
 #include <imgui.h>
@@ -24,6 +30,16 @@ namespace Chopper {
 		void* pUserData
 	);
 
+	static const char* GetPresentModeName(VkPresentModeKHR presentMode) {
+		switch (presentMode) {
+		case VK_PRESENT_MODE_IMMEDIATE_KHR:    return "Immediate";
+		case VK_PRESENT_MODE_MAILBOX_KHR:      return "Mailbox";
+		case VK_PRESENT_MODE_FIFO_KHR:         return "FIFO";
+		case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO Relaxed";
+		default:                               return "Unknown";
+		}
+	}
+
 	VulkanBackend::VulkanBackend() {
 		if (!Init())
 			CHOPPER_LOG_CRIT("Vulkan Backend could not be initialized!");
@@ -39,6 +55,8 @@ namespace Chopper {
 		VkAllocationCallbacks*& allocator = VulkanContext::GetAllocator();
 		VkSurfaceKHR& surface = VulkanContext::GetSurface();
 
+		allocator = VulkanHostAllocator::GetCallbacks();
+
 		VkApplicationInfo appInfo{};
 		appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
 		appInfo.pApplicationName = "Chopper Engine Testbed"; // TODO: Make this configurable
@@ -152,6 +170,7 @@ namespace Chopper {
 		CHOPPER_LOG_DEBUG("Vulkan Window Surface created successfully.");
 
 		VulkanContext::CreateDevice();
+		VulkanContext::CreateMemoryAllocator();
 
 		int w = window.GetWidth(), h = window.GetHeight();
 		VulkanContext::SetFramebufferSize(w, h);
@@ -199,6 +218,10 @@ namespace Chopper {
 		CHOPPER_LOG_DEBUG("Vulkan Descriptor Pool created successfully.");
 
 		VulkanContext::CreateSyncObjects();
+		VulkanContext::CreateGpuTimer();
+		VulkanContext::CreateDefragmenter();
+		VulkanContext::CreateStagingRing();
+		VulkanContext::CreateUploadScheduler();
 
 		CHOPPER_LOG_INFO("Vulkan Backend initialized successfully.");
 		return true;
@@ -213,14 +236,21 @@ namespace Chopper {
 
 		vkDeviceWaitIdle(VulkanContext::GetDevice()->Logical());
 
+		VulkanContext::ReleaseUploadScheduler();
+		VulkanContext::ReleaseStagingRing();
+		VulkanContext::GetDefragmenter()->LogStats();
+		VulkanContext::ReleaseDefragmenter();
+		VulkanContext::ReleaseGpuTimer();
 		VulkanContext::ReleaseSyncObjtects();
 		VulkanContext::ReleaseRenderPass();
 		VulkanContext::DestroySwapchain();
 
 		CHOPPER_LOG_DEBUG("Destroying Vulkan Descriptor Pool...");
-		vkDestroyDescriptorPool(VulkanContext::GetDevice()->Logical(), descriptorPool, nullptr);
+		vkDestroyDescriptorPool(VulkanContext::GetDevice()->Logical(), descriptorPool, allocator);
 		descriptorPool = VK_NULL_HANDLE;
 
+		VulkanContext::GetMemoryAllocator()->LogStats();
+		VulkanContext::ReleaseMemoryAllocator();
 		VulkanContext::ReleaseDevice();
 
 		CHOPPER_LOG_DEBUG("Destroying Vulkan Window Surface...");
@@ -228,6 +258,7 @@ namespace Chopper {
 		surface = VK_NULL_HANDLE;
 #ifdef DEBUG_BUILD
 		VkDebugUtilsMessengerEXT messenger = VulkanContext::GetDebugMessenger();
+		VulkanDebugMessages::LogSummary();
 		CHOPPER_LOG_DEBUG("Destroying Vulkan Debug Messenger...");
 		PFN_vkDestroyDebugUtilsMessengerEXT func = (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance, "vkDestroyDebugUtilsMessengerEXT");
 		func(instance, messenger, allocator);
@@ -236,13 +267,36 @@ namespace Chopper {
 		CHOPPER_LOG_DEBUG("Destroying Vulkan Instance...");
 		vkDestroyInstance(instance, allocator);
 		instance = VK_NULL_HANDLE;
+
+		VulkanHostAllocator::LogStats();
 	}
 
 	bool VulkanBackend::BeginFrame(float deltaTime, void* pImGuiDrawData) {
+		CHOPPER_PROFILE_FUNCTION();
+
 		VkDevice device = VulkanContext::GetDevice()->Logical();
 
+		m_FrameStats = {};
+		VulkanSwapchain* swapchain = VulkanContext::GetSwapchain();
+		m_FrameStats.SwapchainRecreations = swapchain->GetRecreationCount();
+		m_FrameStats.FramesInFlight = swapchain->GetMaxFramesInFlight();
+		m_FrameStats.PresentMode = GetPresentModeName(swapchain->GetPresentMode());
+
+		VulkanHostAllocationStats hostStats = VulkanHostAllocator::GetStats();
+		for (uint32_t i = 0; i < VulkanAllocationScopeCount; ++i) {
+			m_FrameStats.HostLiveAllocations += hostStats.LiveCount[i];
+			m_FrameStats.HostLiveBytes += hostStats.LiveBytes[i];
+		}
+		uint64_t hostAllocationCount = VulkanHostAllocator::GetTotalAllocationCount();
+		m_FrameStats.HostAllocations = hostAllocationCount - m_HostAllocationCount;
+		m_HostAllocationCount = hostAllocationCount;
+
+		uint64_t waitStart = FrameClock::Now();
+
 		if (VulkanContext::IsSwapchainRecreating()) {
+			CHOPPER_PROFILE_SCOPE("VulkanBackend::RecreateSwapchain");
 			VkResult result = vkDeviceWaitIdle(device);
+			m_FrameStats.FenceWaitTime = FrameClock::ToSeconds(FrameClock::Now() - waitStart);
 			if (result != VK_SUCCESS) {
 				CHOPPER_LOG_ERROR("VulkanBackend::BeginFrame() failed!");
 				return false;
@@ -255,17 +309,36 @@ namespace Chopper {
 		VkFence fence = VulkanContext::GetCurrentInFlightFence();
 		VkFence waitFences[] = { fence };
 
-		VK_MSG_CHECK(
-			vkWaitForFences(device, 1, waitFences, VK_TRUE, UINT64_MAX),
-			"InFlightFence had a wait failure!"
-		);
+		{
+			CHOPPER_PROFILE_SCOPE("VulkanBackend::WaitForFence");
+			VK_MSG_CHECK(
+				vkWaitForFences(device, 1, waitFences, VK_TRUE, UINT64_MAX),
+				"InFlightFence had a wait failure!"
+			);
+		}
+		FrameArena::BeginFrame(VulkanContext::GetFrameIndex());
+		VulkanContext::GetDefragmenter()->Update();
+		VulkanContext::GetStagingRing()->BeginFrame(VulkanContext::GetFrameIndex());
+#ifdef DEBUG_BUILD
+		// Repeats stop reaching Report once a flood ends, their last summary is logged from here
+		VulkanDebugMessages::Update();
+#endif
+
+		uint64_t acquireStart = FrameClock::Now();
+		m_FrameStats.FenceWaitTime = FrameClock::ToSeconds(acquireStart - waitStart);
 
 		VkSemaphore imageAvailableSemaphore = VulkanContext::GetCurrentImageAvailableSemaphore();
 
 		uint32_t imageIndex = VulkanContext::GetImageIndex();
-		if (!VulkanContext::GetSwapchain()->AcquireNextImageIndex(
-			UINT64_MAX, imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex)
-		) {
+		bool acquired;
+		{
+			CHOPPER_PROFILE_SCOPE("VulkanBackend::AcquireImage");
+			acquired = VulkanContext::GetSwapchain()->AcquireNextImageIndex(
+				UINT64_MAX, imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex
+			);
+		}
+		m_FrameStats.AcquireTime = FrameClock::ToSeconds(FrameClock::Now() - acquireStart);
+		if (!acquired) {
 			CHOPPER_LOG_WARN("Failed to acquire next image.");
 			return false;
 		}
@@ -275,6 +348,15 @@ namespace Chopper {
 
 		VkCommandBuffer commandBuffer = VulkanContext::GetCurrentCommandBuffer(true);
 
+		VulkanGpuTimer* gpuTimer = VulkanContext::GetGpuTimer();
+		gpuTimer->BeginFrame(commandBuffer, VulkanContext::GetFrameIndex());
+		m_FrameStats.GpuTime = gpuTimer->GetFrameTime();
+
+		// Streamed uploads land before anything of the frame reads them
+		VulkanContext::GetStagingRing()->Record(commandBuffer);
+		// Resources uploaded on the transfer queue by previous frames
+		m_UploadWaitValue = VulkanContext::GetUploadScheduler()->RecordAcquire(commandBuffer);
+
 		float framebufferWidth = static_cast<float>(VulkanContext::GetFramebufferWidth());
 		float framebufferHeight = static_cast<float>(VulkanContext::GetFramebufferHeight());
 
@@ -297,17 +379,26 @@ namespace Chopper {
 		renderArea.offset = { 0, 0 };
 		renderArea.extent = { VulkanContext::GetFramebufferWidth(), VulkanContext::GetFramebufferHeight() };
 
+		m_RenderPassGpuScope = gpuTimer->BeginScope(commandBuffer, "RenderPass");
 		VulkanContext::GetRenderPass()->SetRenderArea(renderArea);
 		VulkanContext::GetRenderPass()->Begin(VulkanContext::GetCurrentFramebuffer());
 
+		uint32_t imGuiScope = gpuTimer->BeginScope(commandBuffer, "ImGui");
 		ImGui_ImplVulkan_RenderDrawData(static_cast<ImDrawData*>(pImGuiDrawData), commandBuffer);
+		gpuTimer->EndScope(commandBuffer, imGuiScope);
 
 		return true;
 	}
 
 	bool VulkanBackend::EndFrame(float deltaTime, void* pImGuiDrawData) {
+		CHOPPER_PROFILE_FUNCTION();
+
 		VulkanContext::GetRenderPass()->End();
 
+		VulkanGpuTimer* gpuTimer = VulkanContext::GetGpuTimer();
+		gpuTimer->EndScope(VulkanContext::GetCurrentCommandBuffer(), m_RenderPassGpuScope);
+		gpuTimer->EndFrame();
+
 		VulkanContext::EndCurrentCommandBuffer();
 
 		VkCommandBuffer commandBuffer[] = { VulkanContext::GetCurrentCommandBuffer() };
@@ -317,31 +408,59 @@ namespace Chopper {
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = commandBuffer;
 		
-		VkSemaphore signalSemaphores[] = { VulkanContext::GetCurrentRenderFinishedSemaphore() };
-		submitInfo.signalSemaphoreCount = 1;
+		// The graphics timeline lets upload batches overwrite resources this frame reads
+		VulkanUploadScheduler* uploadScheduler = VulkanContext::GetUploadScheduler();
+		uint64_t graphicsValue = uploadScheduler->GetNextGraphicsValue();
+		VkSemaphore signalSemaphores[] = { VulkanContext::GetCurrentRenderFinishedSemaphore(), uploadScheduler->GetGraphicsSemaphore() };
+		submitInfo.signalSemaphoreCount = 2;
 		submitInfo.pSignalSemaphores = signalSemaphores;
 
-		VkSemaphore waitSemaphores[] = { VulkanContext::GetCurrentImageAvailableSemaphore() };
-		submitInfo.waitSemaphoreCount = 1;
+		VkSemaphore waitSemaphores[] = { VulkanContext::GetCurrentImageAvailableSemaphore(), uploadScheduler->GetTimelineSemaphore() };
+		submitInfo.waitSemaphoreCount = m_UploadWaitValue ? 2 : 1;
 		submitInfo.pWaitSemaphores = waitSemaphores;
 
-		VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+		VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VulkanUploadScheduler::ConsumerStages };
 		submitInfo.pWaitDstStageMask = waitStages;
 
+		// Binary semaphore values are ignored
+		uint64_t waitValues[] = { 0, m_UploadWaitValue };
+		uint64_t signalValues[] = { 0, graphicsValue };
+		VkTimelineSemaphoreSubmitInfo timelineSubmitInfo{};
+		timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineSubmitInfo.waitSemaphoreValueCount = submitInfo.waitSemaphoreCount;
+		timelineSubmitInfo.pWaitSemaphoreValues = waitValues;
+		timelineSubmitInfo.signalSemaphoreValueCount = submitInfo.signalSemaphoreCount;
+		timelineSubmitInfo.pSignalSemaphoreValues = signalValues;
+		submitInfo.pNext = &timelineSubmitInfo;
+
 		VkQueue graphicsQueue = VulkanContext::GetDevice()->GetGraphicsQueue();
 		VkQueue presentQueue = VulkanContext::GetDevice()->GetPresentQueue();
 
-		VkResult result = vkQueueSubmit(graphicsQueue, 1, &submitInfo, VulkanContext::GetCurrentInFlightFence());
+		VkResult result;
+		{
+			CHOPPER_PROFILE_SCOPE("VulkanBackend::Submit");
+			// Chained with the defragmentation batches, see VulkanDefragmenter
+			result = VulkanContext::GetDefragmenter()->SubmitGraphics(graphicsQueue, submitInfo, VulkanContext::GetCurrentInFlightFence());
+		}
 		if (result != VK_SUCCESS) {
 			CHOPPER_LOG_ERROR("Failed to submit queue!");
 			return false;
 		}
+		uploadScheduler->SetGraphicsSubmitted(graphicsValue);
 
-		VulkanContext::GetSwapchain()->Present(
-			graphicsQueue, presentQueue,
-			VulkanContext::GetCurrentRenderFinishedSemaphore(),
-			VulkanContext::GetImageIndex()
-		);
+		// Runs on the transfer queue while this frame renders, the next frame waits for it
+		uploadScheduler->Submit();
+
+		uint64_t presentStart = FrameClock::Now();
+		{
+			CHOPPER_PROFILE_SCOPE("VulkanBackend::Present");
+			VulkanContext::GetSwapchain()->Present(
+				graphicsQueue, presentQueue,
+				VulkanContext::GetCurrentRenderFinishedSemaphore(),
+				VulkanContext::GetImageIndex()
+			);
+		}
+		m_FrameStats.PresentTime = FrameClock::ToSeconds(FrameClock::Now() - presentStart);
 
 		return true;
 	}
@@ -360,23 +479,7 @@ namespace Chopper {
 		const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
 		void* pUserData
 	) {
-		switch (messageSeverity) {
-		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-			CHOPPER_LOG_TRACE(pCallbackData->pMessage);
-			break;
-		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-			CHOPPER_LOG_INFO(pCallbackData->pMessage);
-			break;
-		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-			CHOPPER_LOG_WARN(pCallbackData->pMessage);
-			break;
-		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
-			CHOPPER_LOG_ERROR(pCallbackData->pMessage);
-			break;
-		default:
-			break;
-		}
-
+		VulkanDebugMessages::Report(messageSeverity, messageType, pCallbackData);
 		return VK_FALSE;
 	}
 
@@ -2,6 +2,8 @@
 
 #include <renderer/RendererBackend.h>
 
+#include "VulkanGpuTimer.h"
+
 namespace Chopper {
 
 	class VulkanBackend : public RendererBackend {
@@ -17,6 +19,12 @@ namespace Chopper {
 	private:
 		bool Init();
 		void Shutdown();
+
+		uint32_t m_RenderPassGpuScope = VulkanGpuTimer::InvalidScope;
+		// Timeline value of the transfer uploads the frame's graphics submit waits for
+		uint64_t m_UploadWaitValue = 0;
+		// Host allocation total at the previous frame, to report the count per frame
+		uint64_t m_HostAllocationCount = 0;
 	};
 
 }
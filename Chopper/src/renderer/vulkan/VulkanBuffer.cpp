@@ -0,0 +1,212 @@
+#include "VulkanBuffer.h"
+
+#include "VulkanContext.h"
+
+#include <core/Logger.h>
+#include <core/Profiler.h>
+
+#include <cstring>
+
+namespace Chopper {
+
+	static VkDeviceSize AlignDown(VkDeviceSize value, VkDeviceSize alignment) {
+		return value / alignment * alignment;
+	}
+
+	static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// Aligned to nonCoherentAtomSize, a range running past a dedicated allocation is clamped to its end
+	static VkMappedMemoryRange GetMappedRange(const VulkanAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) {
+		VkDeviceSize atomSize = VulkanContext::GetDevice()->GetProperties().limits.nonCoherentAtomSize;
+		if (size == VK_WHOLE_SIZE)
+			size = allocation.Size - offset;
+
+		VkMappedMemoryRange range{};
+		range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		range.memory = allocation.Memory;
+		range.offset = AlignDown(allocation.Offset + offset, atomSize);
+		range.size = AlignUp(allocation.Offset + offset + size, atomSize) - range.offset;
+		// Sub-allocations are power of two sized and aligned, so the rounding stays inside the node
+		if (allocation.IsDedicated() && range.offset + range.size > allocation.Size)
+			range.size = VK_WHOLE_SIZE;
+		return range;
+	}
+
+	void VulkanFlushBatch::Add(const VulkanAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) {
+		VkMappedMemoryRange range = GetMappedRange(allocation, offset, size);
+
+		if (!m_Ranges.empty()) {
+			VkMappedMemoryRange& last = m_Ranges.back();
+			if (last.memory == range.memory && last.size != VK_WHOLE_SIZE && last.offset + last.size >= range.offset && range.offset >= last.offset) {
+				last.size = range.size == VK_WHOLE_SIZE ? VK_WHOLE_SIZE : std::max(last.offset + last.size, range.offset + range.size) - last.offset;
+				return;
+			}
+		}
+		m_Ranges.push_back(range);
+	}
+
+	bool VulkanFlushBatch::Flush() {
+		if (m_Ranges.empty())
+			return true;
+
+		VkResult result = vkFlushMappedMemoryRanges(VulkanContext::GetDevice()->Logical(), static_cast<uint32_t>(m_Ranges.size()), m_Ranges.data());
+		m_Ranges.clear();
+		return result == VK_SUCCESS;
+	}
+
+	VulkanBuffer::VulkanBuffer(VkDeviceSize size, VulkanBufferUsage usage, VkBufferUsageFlags extraUsage) {
+		Create(size, usage, extraUsage);
+	}
+
+	VulkanBuffer::~VulkanBuffer() {
+		Release();
+	}
+
+	bool VulkanBuffer::Create(VkDeviceSize size, VulkanBufferUsage usage, VkBufferUsageFlags extraUsage) {
+		Release();
+
+		VulkanMemoryAllocator* memoryAllocator = VulkanContext::GetMemoryAllocator();
+
+		VkBufferUsageFlags bufferUsage = extraUsage;
+		VkMemoryPropertyFlags required = 0;
+		VkMemoryPropertyFlags preferred = 0;
+		VkMemoryPropertyFlags avoided = 0;
+		bool sharedWithTransfer = false;
+		switch (usage) {
+		case VulkanBufferUsage::Vertex:
+		case VulkanBufferUsage::Index:
+		case VulkanBufferUsage::Storage:
+			if (usage == VulkanBufferUsage::Vertex)
+				bufferUsage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+			else if (usage == VulkanBufferUsage::Index)
+				bufferUsage |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+			else
+				bufferUsage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+			bufferUsage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			required = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			// Without resizable BAR the host visible device local heap is small and better left to uniforms
+			if (memoryAllocator->HasResizableBar())
+				preferred = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+			sharedWithTransfer = true;
+			break;
+		case VulkanBufferUsage::Uniform:
+			bufferUsage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+			required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+			preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+			break;
+		case VulkanBufferUsage::Staging:
+			bufferUsage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+			required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+			preferred = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+			// Only written front to back by the CPU: write-combined system memory, keeping the BAR free
+			avoided = VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			break;
+		case VulkanBufferUsage::Readback:
+			bufferUsage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+			preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+			break;
+		}
+
+		VkBufferCreateInfo bufferCreateInfo{};
+		bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferCreateInfo.size = size;
+		bufferCreateInfo.usage = bufferUsage;
+		bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		// Staged writes are copied on the transfer queue and read on the graphics queue
+		const PhysicalDeviceQueueFamilyDetails& queueFamilies = VulkanContext::GetDevice()->GetQueueFamilyIndices();
+		std::array<uint32_t, 2> queueFamilyIndices = { queueFamilies.GraphicsFamilyIndex, queueFamilies.TransferFamilyIndex };
+		if (sharedWithTransfer && queueFamilyIndices[0] != queueFamilyIndices[1]) {
+			bufferCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+			bufferCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilyIndices.size());
+			bufferCreateInfo.pQueueFamilyIndices = queueFamilyIndices.data();
+		}
+
+		if (vkCreateBuffer(VulkanContext::GetDevice()->Logical(), &bufferCreateInfo, VulkanContext::GetAllocator(), &m_Buffer) != VK_SUCCESS) {
+			CHOPPER_LOG_ERROR("Failed to create buffer!");
+			return false;
+		}
+
+		if (!memoryAllocator->AllocateBuffer(m_Buffer, required, m_Allocation, preferred, avoided)) {
+			CHOPPER_LOG_ERROR("Failed to allocate buffer memory!");
+			vkDestroyBuffer(VulkanContext::GetDevice()->Logical(), m_Buffer, VulkanContext::GetAllocator());
+			m_Buffer = VK_NULL_HANDLE;
+			return false;
+		}
+
+		m_Size = size;
+		m_Usage = usage;
+		m_Concurrent = bufferCreateInfo.sharingMode == VK_SHARING_MODE_CONCURRENT;
+		return true;
+	}
+
+	void VulkanBuffer::Release() {
+		if (m_Buffer == VK_NULL_HANDLE)
+			return;
+
+		vkDestroyBuffer(VulkanContext::GetDevice()->Logical(), m_Buffer, VulkanContext::GetAllocator());
+		VulkanContext::GetMemoryAllocator()->Free(m_Allocation);
+		m_Buffer = VK_NULL_HANDLE;
+		m_Size = 0;
+	}
+
+	bool VulkanBuffer::IsCoherent() const {
+		if (!m_Allocation.IsValid())
+			return false;
+		return VulkanContext::GetMemoryAllocator()->GetMemoryTypeFlags(m_Allocation.MemoryType) & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	}
+
+	bool VulkanBuffer::Write(const void* data, VkDeviceSize size, VkDeviceSize offset, VulkanFlushBatch* flushBatch) {
+		CHOPPER_ASSERT(offset + size <= m_Size, "Buffer write out of bounds!");
+
+		if (size == 0)
+			return true;
+
+		if (!IsHostVisible()) {
+			// Frames in flight may still read the buffer, the upload waits for them on the GPU
+			VulkanUploadScheduler* uploadScheduler = VulkanContext::GetUploadScheduler();
+			return !uploadScheduler->HasFailed(uploadScheduler->UploadBuffer(data, size, *this, offset, true));
+		}
+
+		std::memcpy(static_cast<unsigned char*>(m_Allocation.MappedData) + offset, data, size);
+		if (IsCoherent())
+			return true;
+
+		if (flushBatch) {
+			flushBatch->Add(m_Allocation, offset, size);
+			return true;
+		}
+
+		VkMappedMemoryRange range = GetMappedRange(m_Allocation, offset, size);
+		return vkFlushMappedMemoryRanges(VulkanContext::GetDevice()->Logical(), 1, &range) == VK_SUCCESS;
+	}
+
+	bool VulkanBuffer::WriteBlocking(const void* data, VkDeviceSize size, VkDeviceSize offset) {
+		if (IsHostVisible() || size == 0)
+			return Write(data, size, offset);
+
+		CHOPPER_PROFILE_SCOPE("VulkanBuffer::WriteBlocking");
+		VulkanUploadScheduler* uploadScheduler = VulkanContext::GetUploadScheduler();
+		return uploadScheduler->Wait(uploadScheduler->UploadBuffer(data, size, *this, offset, true));
+	}
+
+	bool VulkanBuffer::Invalidate(VkDeviceSize offset, VkDeviceSize size) {
+		if (!IsHostVisible() || IsCoherent())
+			return true;
+
+		VkMappedMemoryRange range = GetMappedRange(m_Allocation, offset, size);
+		return vkInvalidateMappedMemoryRanges(VulkanContext::GetDevice()->Logical(), 1, &range) == VK_SUCCESS;
+	}
+
+	void VulkanBuffer::CopyTo(VkCommandBuffer commandBuffer, const VulkanBuffer& destination, VkDeviceSize sourceOffset, VkDeviceSize destinationOffset, VkDeviceSize size) const {
+		VkBufferCopy region{};
+		region.srcOffset = sourceOffset;
+		region.dstOffset = destinationOffset;
+		region.size = size;
+		vkCmdCopyBuffer(commandBuffer, m_Buffer, destination.m_Buffer, 1, &region);
+	}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include "VulkanMemoryAllocator.h"
+
+#include <vector>
+
+namespace Chopper {
+
+	enum class VulkanBufferUsage {
+		// Device local, written directly when the device exposes host visible VRAM, staged otherwise
+		Vertex,
+		Index,
+		Storage,
+		// Host visible, preferably device local, rewritten every frame
+		Uniform,
+		// Host visible source of transfers
+		Staging,
+		// Host visible and cached destination of transfers
+		Readback
+	};
+
+	// Collects written ranges of non-coherent memory to flush them with a single call.
+	// Ranges are aligned to nonCoherentAtomSize, contiguous ones are merged.
+	class VulkanFlushBatch {
+	public:
+		void Add(const VulkanAllocation& allocation, VkDeviceSize offset, VkDeviceSize size);
+		bool Flush();
+
+		inline bool IsEmpty() const { return m_Ranges.empty(); }
+
+	private:
+		std::vector<VkMappedMemoryRange> m_Ranges;
+	};
+
+	class VulkanBuffer {
+	public:
+		VulkanBuffer() = default;
+		VulkanBuffer(VkDeviceSize size, VulkanBufferUsage usage, VkBufferUsageFlags extraUsage = 0);
+		~VulkanBuffer();
+
+		VulkanBuffer(const VulkanBuffer&) = delete;
+		VulkanBuffer& operator=(const VulkanBuffer&) = delete;
+
+		bool Create(VkDeviceSize size, VulkanBufferUsage usage, VkBufferUsageFlags extraUsage = 0);
+		void Release();
+
+		// Copies straight into the mapping when host visible, non-coherent ranges are flushed right
+		// away or added to the batch. Device local memory is queued on the upload scheduler, the data
+		// is staged right away and frames submitted after the next upload submit see the write.
+		bool Write(const void* data, VkDeviceSize size, VkDeviceSize offset = 0, VulkanFlushBatch* flushBatch = nullptr);
+		// Like Write, but returns once the copy completed on the GPU, stalling the caller
+		bool WriteBlocking(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
+		// Makes device writes visible to the host, needed for non-coherent readback memory
+		bool Invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+		void CopyTo(VkCommandBuffer commandBuffer, const VulkanBuffer& destination, VkDeviceSize sourceOffset, VkDeviceSize destinationOffset, VkDeviceSize size) const;
+
+		inline VkBuffer GetHandle() const { return m_Buffer; }
+		inline VkDeviceSize GetSize() const { return m_Size; }
+		inline VulkanBufferUsage GetUsage() const { return m_Usage; }
+		inline void* GetMappedData() const { return m_Allocation.MappedData; }
+		inline const VulkanAllocation& GetAllocation() const { return m_Allocation; }
+		inline bool IsHostVisible() const { return m_Allocation.MappedData != nullptr; }
+		// Shared between the graphics and transfer families, no ownership transfers needed
+		inline bool IsConcurrent() const { return m_Concurrent; }
+		bool IsCoherent() const;
+
+	private:
+		VkBuffer m_Buffer = VK_NULL_HANDLE;
+		VulkanAllocation m_Allocation{};
+		VkDeviceSize m_Size = 0;
+		VulkanBufferUsage m_Usage = VulkanBufferUsage::Vertex;
+		bool m_Concurrent = false;
+	};
+
+}
@@ -13,8 +13,14 @@ namespace Chopper {
 	VulkanDevice VulkanContext::s_Device{};
 	VulkanSwapchain VulkanContext::s_Swapchain{};
 	VulkanRenderPass VulkanContext::s_RenderPass{};
+	VulkanGpuTimer VulkanContext::s_GpuTimer{};
+	VulkanMemoryAllocator VulkanContext::s_MemoryAllocator{};
+	VulkanDefragmenter VulkanContext::s_Defragmenter{};
+	VulkanStagingRing VulkanContext::s_StagingRing{};
+	VulkanUploadScheduler VulkanContext::s_UploadScheduler{};
 	std::vector<VulkanCommandBuffer> VulkanContext::s_CommandBuffers{};
 	VkDescriptorPool VulkanContext::s_DescriptorPool = VK_NULL_HANDLE;
+	std::mutex VulkanContext::s_TransferQueueMutex;
 	std::vector<VkSemaphore> VulkanContext::s_ImageAvailableSemaphores{};
 	std::vector<VkSemaphore> VulkanContext::s_RenderFinishedSemaphores{};
 	std::vector<VkFence> VulkanContext::s_InFlightFences{};
@@ -35,12 +41,28 @@ namespace Chopper {
 	VulkanDevice* VulkanContext::GetDevice() { return &s_Device; }
 	VulkanSwapchain* VulkanContext::GetSwapchain() { return &s_Swapchain; }
 	VulkanRenderPass* VulkanContext::GetRenderPass() { return &s_RenderPass; }
+	VulkanGpuTimer* VulkanContext::GetGpuTimer() { return &s_GpuTimer; }
+	VulkanMemoryAllocator* VulkanContext::GetMemoryAllocator() { return &s_MemoryAllocator; }
+	VulkanDefragmenter* VulkanContext::GetDefragmenter() { return &s_Defragmenter; }
+	VulkanStagingRing* VulkanContext::GetStagingRing() { return &s_StagingRing; }
+	VulkanUploadScheduler* VulkanContext::GetUploadScheduler() { return &s_UploadScheduler; }
 
 	VkDescriptorPool& VulkanContext::GetDescriptorPool() { return s_DescriptorPool; }
+	std::mutex& VulkanContext::GetTransferQueueMutex() { return s_TransferQueueMutex; }
 
 	bool VulkanContext::CreateDevice() { return s_Device.CreateDevice(); }
 	void VulkanContext::ReleaseDevice() { s_Device.DestroyDevice(); }
 
+	bool VulkanContext::CreateMemoryAllocator() { return s_MemoryAllocator.CreateAllocator(); }
+	void VulkanContext::ReleaseMemoryAllocator() { s_MemoryAllocator.ReleaseAllocator(); }
+
+	bool VulkanContext::CreateDefragmenter() { return s_Defragmenter.CreateDefragmenter(); }
+	void VulkanContext::ReleaseDefragmenter() { s_Defragmenter.ReleaseDefragmenter(); }
+	bool VulkanContext::CreateStagingRing() { return s_StagingRing.CreateStagingRing(VulkanStagingRing::DefaultCapacity, s_Swapchain.m_MaxFramesInFlight); }
+	void VulkanContext::ReleaseStagingRing() { s_StagingRing.ReleaseStagingRing(); }
+	bool VulkanContext::CreateUploadScheduler() { return s_UploadScheduler.CreateUploadScheduler(VulkanUploadScheduler::DefaultStagingCapacity); }
+	void VulkanContext::ReleaseUploadScheduler() { s_UploadScheduler.ReleaseUploadScheduler(); }
+
 	bool VulkanContext::CreateSwapchain(uint32_t width, uint32_t height) { return s_Swapchain.CreateSwapchain(width, height); }
 	void VulkanContext::DestroySwapchain() { return s_Swapchain.DestroySwapchain(); }
 	bool VulkanContext::RecreateSwapchain(uint32_t width, uint32_t height) { return s_Swapchain.RecreateSwapchain(width, height); }
@@ -50,6 +72,9 @@ namespace Chopper {
 	}
 	void VulkanContext::ReleaseRenderPass() { s_RenderPass.ReleaseRenderPass(); }
 
+	bool VulkanContext::CreateGpuTimer() { return s_GpuTimer.CreateGpuTimer(s_Swapchain.m_MaxFramesInFlight); }
+	void VulkanContext::ReleaseGpuTimer() { s_GpuTimer.ReleaseGpuTimer(); }
+
 	void VulkanContext::CreateSyncObjects() {
 		size_t maxFramesInFlight = s_Swapchain.m_MaxFramesInFlight;
 
@@ -107,18 +132,15 @@ namespace Chopper {
 	}
 
 	void VulkanContext::NextFrame() { s_CurrentFrame = (s_CurrentFrame + 1) % s_Swapchain.m_MaxFramesInFlight; }
+	uint32_t VulkanContext::GetFrameIndex() { return s_CurrentFrame; }
 	void VulkanContext::ResetFrameIndex() { s_CurrentFrame = 0; }
 	void VulkanContext::SetFrameIndex(uint32_t frame) { s_CurrentFrame = frame; }
 	uint32_t VulkanContext::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-		VkPhysicalDeviceMemoryProperties memProperties{};
-		vkGetPhysicalDeviceMemoryProperties(s_Device.m_PhysicalDevice, &memProperties);
-
-		for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i)
-			if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-				return i;
-
-		CHOPPER_LOG_WARN("Failed to find suitable memory type!");
-		return (uint32_t)-1;
+		// Memory properties are cached by the allocator, no driver call per lookup
+		uint32_t memoryType = s_MemoryAllocator.FindMemoryType(typeFilter, properties);
+		if (memoryType == (uint32_t)-1)
+			CHOPPER_LOG_WARN("Failed to find suitable memory type!");
+		return memoryType;
 	}
 
 	void VulkanContext::SetFramebufferSize(uint32_t width, uint32_t height) { s_FramebufferWidth = width, s_FramebufferHeight = height; }
@@ -10,6 +10,13 @@
 #include "VulkanSwapchain.h"
 #include "VulkanRenderPass.h"
 #include "VulkanCommandBuffer.h"
+#include "VulkanGpuTimer.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanDefragmenter.h"
+#include "VulkanStagingRing.h"
+#include "VulkanUploadScheduler.h"
+
+#include <mutex>
 
 namespace Chopper {
 
@@ -24,12 +31,29 @@ namespace Chopper {
 		static VulkanDevice* GetDevice();
 		static VulkanSwapchain* GetSwapchain();
 		static VulkanRenderPass* GetRenderPass();
+		static VulkanGpuTimer* GetGpuTimer();
+		static VulkanMemoryAllocator* GetMemoryAllocator();
+		static VulkanDefragmenter* GetDefragmenter();
+		static VulkanStagingRing* GetStagingRing();
+		static VulkanUploadScheduler* GetUploadScheduler();
 
 		static VkDescriptorPool& GetDescriptorPool();
+		// The transfer queue is submitted to from more than one thread
+		static std::mutex& GetTransferQueueMutex();
 
 		static bool CreateDevice();
 		static void ReleaseDevice();
 
+		static bool CreateMemoryAllocator();
+		static void ReleaseMemoryAllocator();
+
+		static bool CreateDefragmenter();
+		static void ReleaseDefragmenter();
+		static bool CreateStagingRing();
+		static void ReleaseStagingRing();
+		static bool CreateUploadScheduler();
+		static void ReleaseUploadScheduler();
+
 		static bool CreateSwapchain(uint32_t width, uint32_t height);
 		static void DestroySwapchain();
 		static bool RecreateSwapchain(uint32_t width, uint32_t height);
@@ -37,6 +61,9 @@ namespace Chopper {
 		static void CreateRenderPass(VkRect2D renderArea, VkClearColorValue clearColor, float depth, int stencil);
 		static void ReleaseRenderPass();
 
+		static bool CreateGpuTimer();
+		static void ReleaseGpuTimer();
+
 		static void CreateSyncObjects();
 		static void ReleaseSyncObjtects();
 
@@ -49,6 +76,7 @@ namespace Chopper {
 		static uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 
 		static void NextFrame();
+		static uint32_t GetFrameIndex();
 		static void ResetFrameIndex();
 		static void SetFrameIndex(uint32_t frame);
 		static void SetFramebufferSize(uint32_t width, uint32_t height);
@@ -78,10 +106,16 @@ namespace Chopper {
 		static VulkanDevice s_Device;
 		static VulkanSwapchain s_Swapchain;
 		static VulkanRenderPass s_RenderPass;
+		static VulkanGpuTimer s_GpuTimer;
+		static VulkanMemoryAllocator s_MemoryAllocator;
+		static VulkanDefragmenter s_Defragmenter;
+		static VulkanStagingRing s_StagingRing;
+		static VulkanUploadScheduler s_UploadScheduler;
 
 		static std::vector<VulkanCommandBuffer> s_CommandBuffers;
 
 		static VkDescriptorPool s_DescriptorPool;
+		static std::mutex s_TransferQueueMutex;
 
 		static std::vector<VkSemaphore> s_ImageAvailableSemaphores;
 		static std::vector<VkSemaphore> s_RenderFinishedSemaphores;
@@ -0,0 +1,155 @@
+#include "VulkanDebugMessages.h"
+
+#include <core/Logger.h>
+#include <core/FrameClock.h>
+
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace Chopper {
+
+	struct DebugMessageEntry {
+		VulkanDebugMessageStats Stats;
+		std::string Message;
+		uint64_t CountAtLastSummary;
+	};
+
+	static std::mutex s_MessageMutex;
+	static std::unordered_map<int64_t, DebugMessageEntry> s_Messages;
+	static uint64_t s_SummaryInterval = 5'000'000'000ull;
+	static uint64_t s_LastSummary = 0;
+	static uint64_t s_TotalCount = 0;
+	static uint64_t s_SuppressedCount = 0;
+
+	template<typename... Args>
+	static void LogWithSeverity(VkDebugUtilsMessageSeverityFlagBitsEXT severity, const char* format, Args&&... args) {
+		switch (severity) {
+		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
+			CHOPPER_LOG_TRACE(format, std::forward<Args>(args)...);
+			break;
+		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
+			CHOPPER_LOG_INFO(format, std::forward<Args>(args)...);
+			break;
+		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
+			CHOPPER_LOG_WARN(format, std::forward<Args>(args)...);
+			break;
+		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
+			CHOPPER_LOG_ERROR(format, std::forward<Args>(args)...);
+			break;
+		default:
+			break;
+		}
+	}
+
+	// Expects s_MessageMutex to be held
+	static void LogSummaryLocked(uint64_t now) {
+		s_LastSummary = now;
+		for (auto& [key, entry] : s_Messages) {
+			uint64_t repeats = entry.Stats.Count - entry.CountAtLastSummary;
+			if (repeats == 0)
+				continue;
+
+			entry.CountAtLastSummary = entry.Stats.Count;
+			LogWithSeverity(entry.Stats.Severity, "Vulkan message {} ({:#010x}) repeated {} more times, {} in total.",
+				entry.Stats.Name, static_cast<uint32_t>(entry.Stats.MessageId), repeats, entry.Stats.Count);
+		}
+	}
+
+	void VulkanDebugMessages::Report(
+		VkDebugUtilsMessageSeverityFlagBitsEXT severity,
+		VkDebugUtilsMessageTypeFlagsEXT type,
+		const VkDebugUtilsMessengerCallbackDataEXT* data
+	) {
+		const char* message = data->pMessage ? data->pMessage : "";
+		const char* name = data->pMessageIdName ? data->pMessageIdName : "Unnamed";
+
+		// Some layers report everything with id 0, tell those apart by their text
+		int64_t key = data->messageIdNumber != 0
+			? static_cast<int64_t>(data->messageIdNumber)
+			: static_cast<int64_t>(std::hash<std::string_view>{}(message) | (1ull << 63));
+
+		uint64_t now = FrameClock::Now();
+
+		std::lock_guard<std::mutex> lock(s_MessageMutex);
+		++s_TotalCount;
+
+		auto [it, inserted] = s_Messages.try_emplace(key);
+		DebugMessageEntry& entry = it->second;
+		if (inserted) {
+			entry.Stats.Key = key;
+			entry.Stats.MessageId = data->messageIdNumber;
+			entry.Stats.Name = name;
+			entry.Message = message;
+			entry.Stats.Severity = severity;
+			entry.Stats.Type = type;
+			entry.Stats.Count = 1;
+			entry.Stats.FirstTime = now;
+			entry.Stats.LastTime = now;
+			entry.CountAtLastSummary = 1;
+			LogWithSeverity(severity, "{}", message);
+		}
+		else {
+			++entry.Stats.Count;
+			entry.Stats.LastTime = now;
+			++s_SuppressedCount;
+		}
+
+		if (now - s_LastSummary >= s_SummaryInterval)
+			LogSummaryLocked(now);
+	}
+
+	void VulkanDebugMessages::LogSummary() {
+		std::lock_guard<std::mutex> lock(s_MessageMutex);
+		LogSummaryLocked(FrameClock::Now());
+	}
+
+	void VulkanDebugMessages::Update() {
+		uint64_t now = FrameClock::Now();
+
+		std::lock_guard<std::mutex> lock(s_MessageMutex);
+		if (now - s_LastSummary >= s_SummaryInterval)
+			LogSummaryLocked(now);
+	}
+
+	void VulkanDebugMessages::SetSummaryInterval(float seconds) {
+		std::lock_guard<std::mutex> lock(s_MessageMutex);
+		s_SummaryInterval = static_cast<uint64_t>(static_cast<double>(seconds) * 1e9);
+	}
+
+	void VulkanDebugMessages::GetStats(std::vector<VulkanDebugMessageStats>& stats) {
+		std::lock_guard<std::mutex> lock(s_MessageMutex);
+		stats.resize(s_Messages.size());
+		size_t i = 0;
+		for (const auto& [key, entry] : s_Messages)
+			stats[i++] = entry.Stats;
+	}
+
+	bool VulkanDebugMessages::CopyMessageText(int64_t key, std::string& message) {
+		std::lock_guard<std::mutex> lock(s_MessageMutex);
+		auto it = s_Messages.find(key);
+		if (it == s_Messages.end())
+			return false;
+
+		message = it->second.Message;
+		return true;
+	}
+
+	uint64_t VulkanDebugMessages::GetTotalCount() {
+		std::lock_guard<std::mutex> lock(s_MessageMutex);
+		return s_TotalCount;
+	}
+
+	uint64_t VulkanDebugMessages::GetSuppressedCount() {
+		std::lock_guard<std::mutex> lock(s_MessageMutex);
+		return s_SuppressedCount;
+	}
+
+	void VulkanDebugMessages::Reset() {
+		std::lock_guard<std::mutex> lock(s_MessageMutex);
+		s_Messages.clear();
+		s_TotalCount = 0;
+		s_SuppressedCount = 0;
+	}
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <common/definitions.h>
+#include <common/includes.h>
+
+namespace Chopper {
+
+	struct VulkanDebugMessageStats {
+		// Identifies the message for CopyMessageText
+		int64_t Key;
+		int32_t MessageId;
+		std::string Name;
+		VkDebugUtilsMessageSeverityFlagBitsEXT Severity;
+		VkDebugUtilsMessageTypeFlagsEXT Type;
+		uint64_t Count;
+		// FrameClock::Now timestamps
+		uint64_t FirstTime;
+		uint64_t LastTime;
+	};
+
+	// Aggregates validation layer messages by messageIdNumber. The first occurrence of each
+	// message is logged in full, repeats are only counted and summarized periodically.
+	class VulkanDebugMessages {
+	public:
+		static void Report(
+			VkDebugUtilsMessageSeverityFlagBitsEXT severity,
+			VkDebugUtilsMessageTypeFlagsEXT type,
+			const VkDebugUtilsMessengerCallbackDataEXT* data
+		);
+
+		// Logs a summary for messages repeated since the last one
+		static void LogSummary();
+		// Logs the summary once the interval elapsed, called once per frame
+		static void Update();
+
+		static void SetSummaryInterval(float seconds);
+
+		// Fills stats in place, reusing its storage
+		static void GetStats(std::vector<VulkanDebugMessageStats>& stats);
+		// Text of the first occurrence, later ones only bump the counters
+		static bool CopyMessageText(int64_t key, std::string& message);
+		static uint64_t GetTotalCount();
+		static uint64_t GetSuppressedCount();
+		static void Reset();
+	};
+
+}
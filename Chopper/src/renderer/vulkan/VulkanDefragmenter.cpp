@@ -0,0 +1,414 @@
+#include "VulkanDefragmenter.h"
+
+#include "VulkanContext.h"
+#include "VulkanImage.h"
+
+#include <core/Logger.h>
+#include <core/Profiler.h>
+
+namespace Chopper {
+
+	static constexpr uint32_t s_MaxMipLevels = 16;
+	static constexpr uint32_t s_MaxGraphicsSemaphores = 4;
+
+	bool VulkanDefragmenter::CreateDefragmenter() {
+		VkDevice device = VulkanContext::GetDevice()->Logical();
+		VkAllocationCallbacks* allocator = VulkanContext::GetAllocator();
+
+		VkCommandPoolCreateInfo commandPoolCreateInfo{};
+		commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		commandPoolCreateInfo.queueFamilyIndex = VulkanContext::GetDevice()->GetQueueFamilyIndices().TransferFamilyIndex;
+
+		if (vkCreateCommandPool(device, &commandPoolCreateInfo, allocator, &m_CommandPool) != VK_SUCCESS) {
+			CHOPPER_LOG_ERROR("Failed to create the defragmentation command pool, defragmentation is disabled.");
+			m_Enabled = false;
+			return false;
+		}
+
+		VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+		commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		commandBufferAllocateInfo.commandPool = m_CommandPool;
+		commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		commandBufferAllocateInfo.commandBufferCount = 1;
+		VK_MSG_CHECK(
+			vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &m_CommandBuffer),
+			"Failed to allocate the defragmentation command buffer!"
+		);
+
+		VkFenceCreateInfo fenceCreateInfo{};
+		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		VK_MSG_CHECK(vkCreateFence(device, &fenceCreateInfo, allocator, &m_Fence), "Failed to create the defragmentation fence!");
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo{};
+		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		VK_MSG_CHECK(vkCreateSemaphore(device, &semaphoreCreateInfo, allocator, &m_GraphicsSemaphore), "Failed to create a defragmentation semaphore!");
+		VK_MSG_CHECK(vkCreateSemaphore(device, &semaphoreCreateInfo, allocator, &m_TransferSemaphore), "Failed to create a defragmentation semaphore!");
+
+		CHOPPER_LOG_DEBUG("Vulkan Defragmenter created.");
+		return true;
+	}
+
+	void VulkanDefragmenter::ReleaseDefragmenter() {
+		if (m_CommandPool == VK_NULL_HANDLE)
+			return;
+
+		VkDevice device = VulkanContext::GetDevice()->Logical();
+		VkAllocationCallbacks* allocator = VulkanContext::GetAllocator();
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (m_BatchInFlight) {
+				vkWaitForFences(device, 1, &m_Fence, VK_TRUE, UINT64_MAX);
+				RetireBatch();
+			}
+			m_Images.clear();
+		}
+
+		CHOPPER_LOG_DEBUG("Destroying Vulkan Defragmenter...");
+		vkDestroySemaphore(device, m_TransferSemaphore, allocator);
+		vkDestroySemaphore(device, m_GraphicsSemaphore, allocator);
+		vkDestroyFence(device, m_Fence, allocator);
+		vkDestroyCommandPool(device, m_CommandPool, allocator);
+
+		m_TransferSemaphore = VK_NULL_HANDLE;
+		m_GraphicsSemaphore = VK_NULL_HANDLE;
+		m_Fence = VK_NULL_HANDLE;
+		m_CommandBuffer = VK_NULL_HANDLE;
+		m_CommandPool = VK_NULL_HANDLE;
+		m_TransferWaitPending = false;
+	}
+
+	void VulkanDefragmenter::Register(VulkanImage* image) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Images.push_back(image);
+	}
+
+	void VulkanDefragmenter::Unregister(VulkanImage* image) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto it = std::find(m_Images.begin(), m_Images.end(), image);
+		if (it != m_Images.end()) {
+			*it = m_Images.back();
+			m_Images.pop_back();
+		}
+
+		// The image already owns the copy destination, it must not be destroyed while being written
+		for (Move& move : m_Moves) {
+			if (move.Owner != image)
+				continue;
+			if (m_BatchInFlight)
+				vkWaitForFences(VulkanContext::GetDevice()->Logical(), 1, &m_Fence, VK_TRUE, UINT64_MAX);
+			move.Owner = nullptr;
+		}
+	}
+
+	void VulkanDefragmenter::Update() {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_BatchInFlight && vkGetFenceStatus(VulkanContext::GetDevice()->Logical(), m_Fence) == VK_SUCCESS)
+			RetireBatch();
+	}
+
+	VkResult VulkanDefragmenter::SubmitGraphics(VkQueue queue, const VkSubmitInfo& submitInfo, VkFence fence) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		bool recorded = false;
+		if (m_Enabled && !m_BatchInFlight && m_CommandPool != VK_NULL_HANDLE) {
+			CHOPPER_PROFILE_SCOPE("VulkanDefragmenter::RecordBatch");
+			recorded = RecordBatch();
+		}
+
+		CHOPPER_ASSERT(submitInfo.waitSemaphoreCount < s_MaxGraphicsSemaphores && submitInfo.signalSemaphoreCount < s_MaxGraphicsSemaphores,
+			"Too many semaphores for the defragmenter to chain the graphics submit!");
+
+		std::array<VkSemaphore, s_MaxGraphicsSemaphores> waitSemaphores{};
+		std::array<VkPipelineStageFlags, s_MaxGraphicsSemaphores> waitStages{};
+		std::array<VkSemaphore, s_MaxGraphicsSemaphores> signalSemaphores{};
+
+		VkSubmitInfo chainedSubmitInfo = submitInfo;
+		std::copy_n(submitInfo.pWaitSemaphores, submitInfo.waitSemaphoreCount, waitSemaphores.begin());
+		std::copy_n(submitInfo.pWaitDstStageMask, submitInfo.waitSemaphoreCount, waitStages.begin());
+		std::copy_n(submitInfo.pSignalSemaphores, submitInfo.signalSemaphoreCount, signalSemaphores.begin());
+		if (m_TransferWaitPending) {
+			waitSemaphores[chainedSubmitInfo.waitSemaphoreCount] = m_TransferSemaphore;
+			waitStages[chainedSubmitInfo.waitSemaphoreCount++] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+		}
+		if (recorded)
+			signalSemaphores[chainedSubmitInfo.signalSemaphoreCount++] = m_GraphicsSemaphore;
+		chainedSubmitInfo.pWaitSemaphores = waitSemaphores.data();
+		chainedSubmitInfo.pWaitDstStageMask = waitStages.data();
+		chainedSubmitInfo.pSignalSemaphores = signalSemaphores.data();
+
+		// Timeline values must cover every semaphore, the binary ones added here are ignored
+		std::array<uint64_t, s_MaxGraphicsSemaphores> waitValues{};
+		std::array<uint64_t, s_MaxGraphicsSemaphores> signalValues{};
+		VkTimelineSemaphoreSubmitInfo chainedTimelineInfo{};
+		const VkBaseInStructure* next = static_cast<const VkBaseInStructure*>(submitInfo.pNext);
+		if (next && next->sType == VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO) {
+			const VkTimelineSemaphoreSubmitInfo* timelineInfo = reinterpret_cast<const VkTimelineSemaphoreSubmitInfo*>(next);
+			chainedTimelineInfo = *timelineInfo;
+			if (timelineInfo->pWaitSemaphoreValues)
+				std::copy_n(timelineInfo->pWaitSemaphoreValues, timelineInfo->waitSemaphoreValueCount, waitValues.begin());
+			if (timelineInfo->pSignalSemaphoreValues)
+				std::copy_n(timelineInfo->pSignalSemaphoreValues, timelineInfo->signalSemaphoreValueCount, signalValues.begin());
+			chainedTimelineInfo.waitSemaphoreValueCount = chainedSubmitInfo.waitSemaphoreCount;
+			chainedTimelineInfo.pWaitSemaphoreValues = waitValues.data();
+			chainedTimelineInfo.signalSemaphoreValueCount = chainedSubmitInfo.signalSemaphoreCount;
+			chainedTimelineInfo.pSignalSemaphoreValues = signalValues.data();
+			chainedSubmitInfo.pNext = &chainedTimelineInfo;
+		}
+
+		VkResult result = vkQueueSubmit(queue, 1, &chainedSubmitInfo, fence);
+		if (result != VK_SUCCESS) {
+			if (recorded)
+				DropBatch();
+			return result;
+		}
+
+		m_TransferWaitPending = false;
+		if (recorded && !SubmitBatch()) {
+			// The graphics semaphore stays signaled with nothing waiting for it, it cannot be reused
+			CHOPPER_LOG_ERROR("Failed to submit a defragmentation batch, defragmentation is disabled.");
+			DropBatch();
+			m_Enabled = false;
+		}
+		return result;
+	}
+
+	bool VulkanDefragmenter::RecordBatch() {
+		VulkanMemoryAllocator* allocator = VulkanContext::GetMemoryAllocator();
+
+		// Nothing was allocated or freed since the last attempt found nothing to move
+		uint64_t generation = allocator->GetGeneration();
+		if (generation == m_IdleGeneration)
+			return false;
+		m_IdleGeneration = generation;
+
+		// Only blocks holding nothing but relocatable images can be emptied
+		m_BlockImageCounts.clear();
+		for (VulkanImage* image : m_Images) {
+			const VulkanMemoryBlock* block = image->m_Allocation.Block;
+			if (!block)
+				continue;
+			auto it = std::find_if(m_BlockImageCounts.begin(), m_BlockImageCounts.end(),
+				[block](const std::pair<const VulkanMemoryBlock*, uint32_t>& count) { return count.first == block; });
+			if (it != m_BlockImageCounts.end())
+				++it->second;
+			else
+				m_BlockImageCounts.emplace_back(block, 1);
+		}
+
+		const VulkanMemoryBlock* source = nullptr;
+		VkDeviceSize sourceUsedBytes = 0;
+		for (const std::pair<const VulkanMemoryBlock*, uint32_t>& count : m_BlockImageCounts) {
+			VulkanMemoryBlockInfo info = allocator->GetBlockInfo(count.first);
+			if (info.PoolBlockCount < 2 || info.AllocationCount != count.second)
+				continue;
+			if (!source || info.UsedBytes < sourceUsedBytes) {
+				source = count.first;
+				sourceUsedBytes = info.UsedBytes;
+			}
+		}
+		if (!source)
+			return false;
+
+		VkDevice device = VulkanContext::GetDevice()->Logical();
+		const PhysicalDeviceQueueFamilyDetails& queueFamilies = VulkanContext::GetDevice()->GetQueueFamilyIndices();
+		std::array<uint32_t, 2> queueFamilyIndices = { queueFamilies.GraphicsFamilyIndex, queueFamilies.TransferFamilyIndex };
+
+		bool recording = false;
+		m_BatchBytes = 0;
+		for (VulkanImage* image : m_Images) {
+			if (image->m_Allocation.Block != source)
+				continue;
+			if (!m_Moves.empty() && m_BatchBytes + image->m_Allocation.Size > m_FrameBudget)
+				break;
+
+			// The copy has the same create info, so the same size and alignment as the image itself
+			VkMemoryRequirements requirements{};
+			vkGetImageMemoryRequirements(device, image->m_Image, &requirements);
+			if (!allocator->CanReallocate(requirements, image->m_Allocation))
+				break;
+
+			if (!recording) {
+				vkResetCommandPool(device, m_CommandPool, 0);
+				VkCommandBufferBeginInfo beginInfo{};
+				beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+				beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+				vkBeginCommandBuffer(m_CommandBuffer, &beginInfo);
+				recording = true;
+			}
+
+			VkImageCreateInfo imageCreateInfo = image->m_CreateInfo;
+			if (imageCreateInfo.sharingMode == VK_SHARING_MODE_CONCURRENT)
+				imageCreateInfo.pQueueFamilyIndices = queueFamilyIndices.data();
+
+			VkImage destination = VK_NULL_HANDLE;
+			if (vkCreateImage(device, &imageCreateInfo, VulkanContext::GetAllocator(), &destination) != VK_SUCCESS)
+				break;
+
+			vkGetImageMemoryRequirements(device, destination, &requirements);
+
+			VulkanAllocation allocation{};
+			if (!allocator->Reallocate(requirements, image->m_Allocation, allocation) ||
+				vkBindImageMemory(device, destination, allocation.Memory, allocation.Offset) != VK_SUCCESS) {
+				// No fuller block has room left, the source block cannot be emptied for now
+				allocator->Free(allocation);
+				vkDestroyImage(device, destination, VulkanContext::GetAllocator());
+				break;
+			}
+
+			RecordMove(image, destination);
+			m_Moves.push_back({ image, destination, allocation, VK_NULL_HANDLE });
+			m_BatchBytes += allocation.Size;
+		}
+
+		if (!recording)
+			return false;
+
+		// An empty command buffer when the very first move failed after all, it is reset before reuse
+		vkEndCommandBuffer(m_CommandBuffer);
+		return !m_Moves.empty();
+	}
+
+	void VulkanDefragmenter::RecordMove(VulkanImage* image, VkImage destination) {
+		// Undefined contents need no copy, the image only changes place
+		VkImageLayout layout = image->m_Layout;
+		if (layout == VK_IMAGE_LAYOUT_UNDEFINED)
+			return;
+
+		const VkImageCreateInfo& createInfo = image->m_CreateInfo;
+		VkImageAspectFlags aspectFlags = image->m_AspectFlags ? image->m_AspectFlags : VK_IMAGE_ASPECT_COLOR_BIT;
+		uint32_t mipLevels = std::min(createInfo.mipLevels, s_MaxMipLevels);
+
+		VkImageMemoryBarrier barriers[2]{};
+		for (VkImageMemoryBarrier& barrier : barriers) {
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.subresourceRange.aspectMask = aspectFlags;
+			barrier.subresourceRange.baseMipLevel = 0;
+			barrier.subresourceRange.levelCount = mipLevels;
+			barrier.subresourceRange.baseArrayLayer = 0;
+			barrier.subresourceRange.layerCount = createInfo.arrayLayers;
+		}
+
+		// The semaphore wait already covers the graphics work, the barriers only chain onto it
+		barriers[0].image = image->m_Image;
+		barriers[0].oldLayout = layout;
+		barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barriers[0].srcAccessMask = 0;
+		barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+		barriers[1].image = destination;
+		barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barriers[1].srcAccessMask = 0;
+		barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(m_CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+			0, nullptr, 0, nullptr, 2, barriers);
+
+		std::array<VkImageCopy, s_MaxMipLevels> regions{};
+		for (uint32_t mip = 0; mip < mipLevels; ++mip) {
+			VkImageCopy& region = regions[mip];
+			region.srcSubresource.aspectMask = aspectFlags;
+			region.srcSubresource.mipLevel = mip;
+			region.srcSubresource.baseArrayLayer = 0;
+			region.srcSubresource.layerCount = createInfo.arrayLayers;
+			region.dstSubresource = region.srcSubresource;
+			region.extent.width = std::max(createInfo.extent.width >> mip, 1u);
+			region.extent.height = std::max(createInfo.extent.height >> mip, 1u);
+			region.extent.depth = std::max(createInfo.extent.depth >> mip, 1u);
+		}
+		vkCmdCopyImage(m_CommandBuffer, image->m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			destination, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels, regions.data());
+
+		// Left in the layout the image had, the transfer semaphore makes the copy visible to the next frame
+		VkImageMemoryBarrier& restore = barriers[1];
+		restore.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		restore.newLayout = layout;
+		restore.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		restore.dstAccessMask = 0;
+		vkCmdPipelineBarrier(m_CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+			0, nullptr, 0, nullptr, 1, &restore);
+	}
+
+	bool VulkanDefragmenter::SubmitBatch() {
+		VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.waitSemaphoreCount = 1;
+		submitInfo.pWaitSemaphores = &m_GraphicsSemaphore;
+		submitInfo.pWaitDstStageMask = &waitStage;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &m_CommandBuffer;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &m_TransferSemaphore;
+
+		{
+			std::lock_guard<std::mutex> queueLock(VulkanContext::GetTransferQueueMutex());
+			if (vkQueueSubmit(VulkanContext::GetDevice()->GetTransferQueue(), 1, &submitInfo, m_Fence) != VK_SUCCESS)
+				return false;
+		}
+
+		// Frame N + 1 is recorded against the new images and waits for the copies
+		for (Move& move : m_Moves) {
+			VulkanImage* image = move.Owner;
+			std::swap(image->m_Image, move.Image);
+			std::swap(image->m_Allocation, move.Allocation);
+			if (image->m_ImageView != VK_NULL_HANDLE) {
+				move.View = image->m_ImageView;
+				image->m_ImageView = VK_NULL_HANDLE;
+				image->CreateImageView(image->m_CreateInfo.format, image->m_AspectFlags);
+			}
+		}
+
+		m_BatchInFlight = true;
+		m_TransferWaitPending = true;
+		++m_Stats.Batches;
+		m_Stats.Moves += m_Moves.size();
+		m_Stats.MovedBytes += m_BatchBytes;
+		return true;
+	}
+
+	void VulkanDefragmenter::DropBatch() {
+		// Nothing was swapped yet, the moves still hold the unused destinations
+		VkDevice device = VulkanContext::GetDevice()->Logical();
+		for (Move& move : m_Moves) {
+			vkDestroyImage(device, move.Image, VulkanContext::GetAllocator());
+			VulkanContext::GetMemoryAllocator()->Free(move.Allocation);
+		}
+		m_Moves.clear();
+	}
+
+	void VulkanDefragmenter::RetireBatch() {
+		VkDevice device = VulkanContext::GetDevice()->Logical();
+		VkAllocationCallbacks* allocator = VulkanContext::GetAllocator();
+		VulkanMemoryAllocator* memoryAllocator = VulkanContext::GetMemoryAllocator();
+
+		VkDeviceSize releasedBytes = memoryAllocator->GetReleasedBytes();
+		for (Move& move : m_Moves) {
+			if (move.View != VK_NULL_HANDLE)
+				vkDestroyImageView(device, move.View, allocator);
+			vkDestroyImage(device, move.Image, allocator);
+			memoryAllocator->Free(move.Allocation);
+		}
+		VkDeviceSize reclaimedBytes = memoryAllocator->GetReleasedBytes() - releasedBytes;
+		m_Stats.ReclaimedBytes += reclaimedBytes;
+
+		CHOPPER_LOG_DEBUG("Defragmentation batch done: {} images moved ({:.1f} MiB), {:.1f} MiB reclaimed.",
+			m_Moves.size(), m_BatchBytes / (1024.0 * 1024.0), reclaimedBytes / (1024.0 * 1024.0));
+
+		m_Moves.clear();
+		vkResetFences(device, 1, &m_Fence);
+		m_BatchInFlight = false;
+	}
+
+	void VulkanDefragmenter::LogStats() const {
+		CHOPPER_LOG_INFO("Vulkan defragmentation: {} batches, {} images moved ({:.1f} MiB copied), {:.1f} MiB reclaimed.",
+			m_Stats.Batches, m_Stats.Moves, m_Stats.MovedBytes / (1024.0 * 1024.0), m_Stats.ReclaimedBytes / (1024.0 * 1024.0));
+	}
+
+}
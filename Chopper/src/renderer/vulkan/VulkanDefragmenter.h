@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include "VulkanMemoryAllocator.h"
+
+#include <vector>
+#include <mutex>
+
+namespace Chopper {
+
+	class VulkanImage;
+
+	struct VulkanDefragmentationStats {
+		uint32_t Batches = 0;
+		uint64_t Moves = 0;
+		VkDeviceSize MovedBytes = 0;
+		// Memory blocks given back to the driver after their last allocation was moved out
+		VkDeviceSize ReclaimedBytes = 0;
+	};
+
+	// Incrementally empties the sparsest memory block of a pool by moving its relocatable images
+	// into fuller blocks. At most one batch is in flight: it is recorded on the transfer queue
+	// after the graphics submit of frame N, handles are swapped before frame N + 1 is recorded,
+	// and frame N + 1 waits for the copies. The old images are released once the batch's fence
+	// signaled, by then every frame that used them has completed.
+	class VulkanDefragmenter {
+		friend class VulkanContext;
+	public:
+		static constexpr VkDeviceSize DefaultFrameBudget = 16ull * 1024 * 1024;
+
+		inline void SetEnabled(bool enabled) { m_Enabled = enabled; }
+		inline bool IsEnabled() const { return m_Enabled; }
+		// Bytes copied per batch, a single larger image is still moved on its own
+		inline void SetFrameBudget(VkDeviceSize budget) { m_FrameBudget = budget; }
+
+		void Register(VulkanImage* image);
+		void Unregister(VulkanImage* image);
+
+		// Called once the frame's in-flight fence signaled, releases the memory of a completed batch
+		void Update();
+
+		// Submits the frame to the graphics queue, chained with the defragmentation batches: waits
+		// for the previous batch if that has not happened yet, and records and submits a new one
+		// behind it when there is something to move.
+		VkResult SubmitGraphics(VkQueue queue, const VkSubmitInfo& submitInfo, VkFence fence);
+
+		inline const VulkanDefragmentationStats& GetStats() const { return m_Stats; }
+		void LogStats() const;
+
+	private:
+		bool CreateDefragmenter();
+		void ReleaseDefragmenter();
+
+		bool RecordBatch();
+		void RecordMove(VulkanImage* image, VkImage destination);
+		bool SubmitBatch();
+		void DropBatch();
+		void RetireBatch();
+
+		struct Move {
+			// Null once the image was unregistered
+			VulkanImage* Owner;
+			VkImage Image;
+			VulkanAllocation Allocation;
+			VkImageView View;
+		};
+
+		std::vector<VulkanImage*> m_Images;
+		// Relocatable image count per memory block, reused by every batch
+		std::vector<std::pair<const VulkanMemoryBlock*, uint32_t>> m_BlockImageCounts;
+		std::mutex m_Mutex;
+
+		// New images and memory while recorded, the replaced ones once submitted
+		std::vector<Move> m_Moves;
+		bool m_BatchInFlight = false;
+		VkDeviceSize m_BatchBytes = 0;
+
+		VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+		VkCommandBuffer m_CommandBuffer = VK_NULL_HANDLE;
+		VkFence m_Fence = VK_NULL_HANDLE;
+		// Signaled by the graphics submit the batch waits for
+		VkSemaphore m_GraphicsSemaphore = VK_NULL_HANDLE;
+		// Signaled by the batch, waited for by the next graphics submit
+		VkSemaphore m_TransferSemaphore = VK_NULL_HANDLE;
+		bool m_TransferWaitPending = false;
+
+		// Allocator generation when the last attempt found nothing to move, retried once it changed
+		uint64_t m_IdleGeneration = UINT64_MAX;
+
+		bool m_Enabled = true;
+		VkDeviceSize m_FrameBudget = DefaultFrameBudget;
+		VulkanDefragmentationStats m_Stats{};
+	};
+
+}
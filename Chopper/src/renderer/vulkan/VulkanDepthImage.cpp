@@ -54,24 +54,10 @@ namespace Chopper {
 			"Failed to create depth image!"
 		);
 
-		VkMemoryRequirements memRequirements{};
-		vkGetImageMemoryRequirements(device->Logical(), m_Image, &memRequirements);
-
-		uint32_t memoryType = VulkanContext::FindMemoryType(memRequirements.memoryTypeBits, properties);
-		if (memoryType == (uint32_t)-1)
-			CHOPPER_LOG_ERROR("Depth image required an unavailable memory type.");
-
-		VkMemoryAllocateInfo memAllocInfo{};
-		memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		memAllocInfo.allocationSize = memRequirements.size;
-		memAllocInfo.memoryTypeIndex = memoryType;
-
-		VK_MSG_CHECK(
-			vkAllocateMemory(device->Logical(), &memAllocInfo, VulkanContext::GetAllocator(), &m_ImageMemory),
-			"Failed to allocate depth image memory"
-		);
-
-		vkBindImageMemory(device->Logical(), m_Image, m_ImageMemory, 0);
+		if (!VulkanContext::GetMemoryAllocator()->AllocateImage(m_Image, properties, tiling, m_Allocation)) {
+			CHOPPER_LOG_ERROR("Failed to allocate depth image memory");
+			return;
+		}
 
 		if (stencilAttachment &&
 			depthFormat != VK_FORMAT_D16_UNORM_S8_UINT &&
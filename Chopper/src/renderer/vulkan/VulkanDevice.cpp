@@ -66,8 +66,14 @@ namespace Chopper {
 		VkPhysicalDeviceFeatures deviceFeatures{};
 		deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+		// Transfer queue uploads are tracked with a timeline semaphore
+		VkPhysicalDeviceVulkan12Features vulkan12Features{};
+		vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		vulkan12Features.timelineSemaphore = VK_TRUE;
+
 		VkDeviceCreateInfo deviceCreateInfo{};
 		deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		deviceCreateInfo.pNext = &vulkan12Features;
 		deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 		deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
 		deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
@@ -85,7 +91,9 @@ namespace Chopper {
 
 		vkGetDeviceQueue(m_LogicalDevice, m_QueueFamilyIndices.GraphicsFamilyIndex, 0, &m_GraphicsQueue);
 		vkGetDeviceQueue(m_LogicalDevice, m_QueueFamilyIndices.PresentFamilyIndex, 0, &m_PresentQueue);
-		vkGetDeviceQueue(m_LogicalDevice, m_QueueFamilyIndices.TransferFamilyIndex, 0, &m_TransferQueue);
+		// The graphics family is created with a second queue, transfers get it when they share the family
+		uint32_t transferQueueIndex = m_QueueFamilyIndices.TransferFamilyIndex == m_QueueFamilyIndices.GraphicsFamilyIndex ? 1 : 0;
+		vkGetDeviceQueue(m_LogicalDevice, m_QueueFamilyIndices.TransferFamilyIndex, transferQueueIndex, &m_TransferQueue);
 
 		VkCommandPoolCreateInfo commandPoolCreateInfo{};
 		commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -148,6 +156,7 @@ namespace Chopper {
 			// TODO: Compute support might be enabled when RT support is implemented
 			requirements.ComputeSupport = VK_FALSE;
 			requirements.SamplerAnisotropy = VK_TRUE;
+			requirements.TimelineSemaphore = VK_TRUE;
 			requirements.DiscreteGPU = VK_TRUE;
 			requirements.DeviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 
@@ -356,6 +365,22 @@ namespace Chopper {
 			return false;
 		}
 
+		// Timeline semaphore requirement, core since Vulkan 1.2
+		if (requirements.TimelineSemaphore) {
+			VkPhysicalDeviceVulkan12Features vulkan12Features{};
+			vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+			VkPhysicalDeviceFeatures2 features2{};
+			features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			features2.pNext = &vulkan12Features;
+			if (properties.apiVersion >= VK_API_VERSION_1_2)
+				vkGetPhysicalDeviceFeatures2(device, &features2);
+
+			if (!vulkan12Features.timelineSemaphore) {
+				CHOPPER_LOG_INFO("Candidate device does not support TimelineSemaphore.");
+				return false;
+			}
+		}
+
 		return true;
 	}
 
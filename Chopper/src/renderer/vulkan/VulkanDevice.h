@@ -23,6 +23,7 @@ namespace Chopper {
 		VkBool32 ComputeSupport;
 		VkBool32 TransferSupport;
 		VkBool32 SamplerAnisotropy;
+		VkBool32 TimelineSemaphore;
 		VkBool32 DiscreteGPU;
 		std::vector<const char*> DeviceExtensions;
 	};
@@ -44,6 +45,7 @@ namespace Chopper {
 
 		const PhysicalDeviceQueueFamilyDetails& GetQueueFamilyIndices() const { return m_QueueFamilyIndices; }
 		const SwapchainSupportDetails& GetSwapchainSupportDetails() const { return m_SwapchainSupport; }
+		const VkPhysicalDeviceProperties& GetProperties() const { return m_PhysicalDeviceDetails.Properties; }
 		const VkFormat GetDepthFormat();
 		SwapchainSupportDetails QuerySwapchainSupport(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, bool update = false);
 
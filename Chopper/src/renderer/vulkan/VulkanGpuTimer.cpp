@@ -0,0 +1,162 @@
+#include "VulkanGpuTimer.h"
+
+#include "VulkanContext.h"
+
+#include <common/includes.h>
+
+#include <core/FrameClock.h>
+#include <core/Profiler.h>
+
+namespace Chopper {
+
+	bool VulkanGpuTimer::CreateGpuTimer(uint32_t frameCount) {
+		VulkanDevice* device = VulkanContext::GetDevice();
+		const VkPhysicalDeviceProperties& properties = device->GetProperties();
+
+		uint32_t queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(device->Physical(), &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(device->Physical(), &queueFamilyCount, queueFamilies.data());
+
+		uint32_t validBits = queueFamilies[device->GetQueueFamilyIndices().GraphicsFamilyIndex].timestampValidBits;
+		if (validBits == 0 || properties.limits.timestampPeriod <= 0.0f) {
+			CHOPPER_LOG_WARN("Graphics queue does not support timestamps, GPU timings are disabled.");
+			return false;
+		}
+
+		m_TimestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+		m_TimestampPeriod = static_cast<double>(properties.limits.timestampPeriod);
+
+		VkQueryPoolCreateInfo queryPoolCreateInfo{};
+		queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolCreateInfo.queryCount = MaxScopes * 2;
+
+		m_QueryPools.resize(frameCount, VK_NULL_HANDLE);
+		m_Frames.assign(frameCount, {});
+		for (auto& queryPool : m_QueryPools) {
+			if (vkCreateQueryPool(device->Logical(), &queryPoolCreateInfo, VulkanContext::GetAllocator(), &queryPool) != VK_SUCCESS) {
+				CHOPPER_LOG_ERROR("Failed to create Vulkan timestamp Query Pool, GPU timings are disabled.");
+				ReleaseGpuTimer();
+				return false;
+			}
+		}
+		m_ScopeTimings.reserve(MaxScopes);
+
+		CHOPPER_LOG_DEBUG("Vulkan GPU Timer created successfully ({} valid timestamp bits, {} ns per tick).", validBits, m_TimestampPeriod);
+		return true;
+	}
+
+	void VulkanGpuTimer::ReleaseGpuTimer() {
+		CHOPPER_LOG_DEBUG("Destroying Vulkan GPU Timer...");
+		for (auto& queryPool : m_QueryPools) {
+			if (queryPool != VK_NULL_HANDLE)
+				vkDestroyQueryPool(VulkanContext::GetDevice()->Logical(), queryPool, VulkanContext::GetAllocator());
+		}
+		m_QueryPools.clear();
+		m_Frames.clear();
+		m_ScopeTimings.clear();
+		m_FrameTime = 0.0f;
+	}
+
+	void VulkanGpuTimer::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame) {
+		if (!IsSupported() || frame >= m_QueryPools.size())
+			return;
+
+		m_CurrentFrame = frame;
+		ResolveFrame(frame);
+
+		FrameQueries& queries = m_Frames[frame];
+		queries.ScopeCount = 0;
+		queries.Submitted = false;
+		vkCmdResetQueryPool(commandBuffer, m_QueryPools[frame], 0, MaxScopes * 2);
+	}
+
+	void VulkanGpuTimer::EndFrame() {
+		if (!IsSupported() || m_CurrentFrame >= m_Frames.size())
+			return;
+
+		FrameQueries& queries = m_Frames[m_CurrentFrame];
+		queries.Submitted = queries.ScopeCount != 0;
+		queries.SubmitTime = FrameClock::Now();
+	}
+
+	uint32_t VulkanGpuTimer::BeginScope(VkCommandBuffer commandBuffer, const char* name) {
+		if (!IsSupported())
+			return InvalidScope;
+
+		FrameQueries& queries = m_Frames[m_CurrentFrame];
+		if (queries.ScopeCount >= MaxScopes)
+			return InvalidScope;
+
+		uint32_t scope = queries.ScopeCount++;
+		queries.ScopeNames[scope] = name;
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_QueryPools[m_CurrentFrame], scope * 2);
+		return scope;
+	}
+
+	void VulkanGpuTimer::EndScope(VkCommandBuffer commandBuffer, uint32_t scope) {
+		if (scope == InvalidScope)
+			return;
+
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_QueryPools[m_CurrentFrame], scope * 2 + 1);
+	}
+
+	void VulkanGpuTimer::ResolveFrame(uint32_t frame) {
+		FrameQueries& queries = m_Frames[frame];
+		if (!queries.Submitted)
+			return;
+
+		uint32_t queryCount = queries.ScopeCount * 2;
+		VkResult result = vkGetQueryPoolResults(
+			VulkanContext::GetDevice()->Logical(), m_QueryPools[frame], 0, queryCount,
+			sizeof(uint64_t) * 2 * queryCount, m_Results.data(), sizeof(uint64_t) * 2,
+			VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+		);
+		// VK_NOT_READY only means some of them are missing, availability is checked per query
+		if (result != VK_SUCCESS && result != VK_NOT_READY)
+			return;
+
+		m_ScopeTimings.clear();
+
+		uint64_t first = ~0ull;
+		uint64_t last = 0;
+		for (uint32_t i = 0; i < queries.ScopeCount; ++i) {
+			const uint64_t* begin = &m_Results[i * 4];
+			const uint64_t* end = &m_Results[i * 4 + 2];
+			if (!begin[1] || !end[1])
+				continue;
+
+			first = std::min(first, begin[0] & m_TimestampMask);
+			last = std::max(last, end[0] & m_TimestampMask);
+		}
+		if (first > last) {
+			m_FrameTime = 0.0f;
+			return;
+		}
+		m_FrameTime = static_cast<float>(static_cast<double>(last - first) * m_TimestampPeriod * 1e-9);
+
+		// Core Vulkan has no CPU/GPU clock correlation, the frame is placed on the GPU track at its
+		// submit time, or right after the previous GPU frame when the GPU was running behind
+		uint64_t base = std::max(queries.SubmitTime, m_LastTrackEnd);
+		for (uint32_t i = 0; i < queries.ScopeCount; ++i) {
+			const uint64_t* begin = &m_Results[i * 4];
+			const uint64_t* end = &m_Results[i * 4 + 2];
+			if (!begin[1] || !end[1])
+				continue;
+
+			uint64_t beginTicks = (begin[0] & m_TimestampMask) - first;
+			uint64_t endTicks = std::max((end[0] & m_TimestampMask) - first, beginTicks);
+			double duration = static_cast<double>(endTicks - beginTicks) * m_TimestampPeriod;
+			m_ScopeTimings.push_back({ queries.ScopeNames[i], static_cast<float>(duration * 1e-9) });
+
+			if (Profiler::IsCapturing()) {
+				uint64_t start = base + static_cast<uint64_t>(static_cast<double>(beginTicks) * m_TimestampPeriod);
+				Profiler::RecordGpu(queries.ScopeNames[i], start, start + static_cast<uint64_t>(duration));
+			}
+		}
+		m_LastTrackEnd = base + static_cast<uint64_t>(static_cast<double>(last - first) * m_TimestampPeriod);
+		queries.Submitted = false;
+	}
+
+}
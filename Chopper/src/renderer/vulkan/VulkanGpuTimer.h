@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <vector>
+
+namespace Chopper {
+
+	struct VulkanGpuScopeTiming {
+		// Must outlive the timer, scope names are string literals
+		const char* Name;
+		// Seconds
+		float Time;
+	};
+
+	// GPU timestamp queries, one query pool per frame in flight. Results of a frame are read
+	// back without waiting once its in-flight fence signaled again, that is frames in flight
+	// frames later, and forwarded to the profiler on a separate "GPU" track.
+	class VulkanGpuTimer {
+		friend class VulkanContext;
+	public:
+		static constexpr uint32_t MaxScopes = 16;
+		static constexpr uint32_t InvalidScope = (uint32_t)-1;
+
+		inline bool IsSupported() const { return m_QueryPools.size() != 0; }
+
+		// Must be called outside of a render pass, once the in-flight fence of the frame slot signaled
+		void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame);
+		// Called right before the frame is submitted
+		void EndFrame();
+
+		uint32_t BeginScope(VkCommandBuffer commandBuffer, const char* name);
+		void EndScope(VkCommandBuffer commandBuffer, uint32_t scope);
+
+		// GPU time between the first and the last timestamp of the latest resolved frame, in seconds
+		inline float GetFrameTime() const { return m_FrameTime; }
+		inline const std::vector<VulkanGpuScopeTiming>& GetScopeTimings() const { return m_ScopeTimings; }
+
+	private:
+		bool CreateGpuTimer(uint32_t frameCount);
+		void ReleaseGpuTimer();
+
+		void ResolveFrame(uint32_t frame);
+
+		struct FrameQueries {
+			std::array<const char*, MaxScopes> ScopeNames{};
+			uint32_t ScopeCount = 0;
+			bool Submitted = false;
+			// FrameClock::Now when the frame was submitted, used to place the scopes on the CPU timeline
+			uint64_t SubmitTime = 0;
+		};
+
+		std::vector<VkQueryPool> m_QueryPools;
+		std::vector<FrameQueries> m_Frames;
+		// Timestamp and availability pairs for both queries of every scope
+		std::array<uint64_t, MaxScopes * 4> m_Results{};
+
+		uint32_t m_CurrentFrame = 0;
+
+		uint64_t m_TimestampMask = 0;
+		double m_TimestampPeriod = 0.0;
+		uint64_t m_LastTrackEnd = 0;
+
+		float m_FrameTime = 0.0f;
+		std::vector<VulkanGpuScopeTiming> m_ScopeTimings;
+	};
+
+}
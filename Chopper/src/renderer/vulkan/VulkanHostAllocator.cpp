@@ -0,0 +1,293 @@
+#include "VulkanHostAllocator.h"
+
+#include <core/Logger.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace Chopper {
+
+	// Stored right in front of every block handed to the driver
+	struct alignas(16) HostAllocationHeader {
+		uint64_t Size;
+		// Distance from the start of the underlying block, up to the alignment plus the header
+		uint32_t Offset;
+		// Vulkan alignments are powers of two
+		uint8_t AlignmentShift;
+		uint8_t Scope;
+		uint8_t SizeClass;
+	};
+	static_assert(sizeof(HostAllocationHeader) == 16, "Header must keep 16 byte alignment");
+
+	static constexpr uint8_t s_Unpooled = 0xFF;
+	static constexpr uint32_t s_SizeClassCount = 7;
+	static constexpr uint32_t s_MinSizeClass = 64;
+	static constexpr uint32_t s_MaxPooledAlignment = 64;
+	static constexpr uint32_t s_ThreadCacheLimit = 64;
+	static constexpr uint32_t s_GlobalCacheLimit = 256;
+
+	struct HostAllocatorCounters {
+		std::array<std::atomic<uint64_t>, VulkanAllocationScopeCount> LiveBytes{};
+		std::array<std::atomic<uint64_t>, VulkanAllocationScopeCount> LiveCount{};
+		std::array<std::atomic<uint64_t>, VulkanAllocationScopeCount> TotalCount{};
+		std::array<std::atomic<uint64_t>, VulkanAllocationScopeCount> TotalBytes{};
+		std::array<std::atomic<uint64_t>, VulkanAllocationScopeCount> InternalBytes{};
+		std::atomic<uint64_t> Reallocations{ 0 };
+		std::atomic<uint64_t> PoolHits{ 0 };
+		std::atomic<uint64_t> PoolMisses{ 0 };
+	};
+
+	static HostAllocatorCounters s_Counters;
+	static std::atomic<bool> s_PoolingEnabled{ true };
+
+	// Free blocks are linked through their first bytes
+	struct FreeBlock {
+		FreeBlock* Next;
+	};
+
+	struct GlobalBlockCache {
+		std::mutex Mutex;
+		std::array<FreeBlock*, s_SizeClassCount> Heads{};
+		std::array<uint32_t, s_SizeClassCount> Counts{};
+	};
+
+	static GlobalBlockCache s_GlobalCache;
+
+	struct ThreadBlockCache {
+		std::array<FreeBlock*, s_SizeClassCount> Heads{};
+		std::array<uint32_t, s_SizeClassCount> Counts{};
+
+		~ThreadBlockCache() {
+			std::lock_guard<std::mutex> lock(s_GlobalCache.Mutex);
+			for (uint32_t i = 0; i < s_SizeClassCount; ++i) {
+				while (FreeBlock* block = Heads[i]) {
+					Heads[i] = block->Next;
+					if (s_GlobalCache.Counts[i] < s_GlobalCacheLimit) {
+						block->Next = s_GlobalCache.Heads[i];
+						s_GlobalCache.Heads[i] = block;
+						++s_GlobalCache.Counts[i];
+					}
+					else
+						std::free(block);
+				}
+			}
+		}
+	};
+
+	static thread_local ThreadBlockCache s_ThreadCache;
+
+	static inline uint32_t GetSizeClassSize(uint8_t sizeClass) { return s_MinSizeClass << sizeClass; }
+
+	static uint8_t FindSizeClass(size_t blockSize) {
+		for (uint8_t i = 0; i < s_SizeClassCount; ++i) {
+			if (blockSize <= GetSizeClassSize(i))
+				return i;
+		}
+		return s_Unpooled;
+	}
+
+	static void* AcquireBlock(uint8_t sizeClass) {
+		ThreadBlockCache& cache = s_ThreadCache;
+		if (FreeBlock* block = cache.Heads[sizeClass]) {
+			cache.Heads[sizeClass] = block->Next;
+			--cache.Counts[sizeClass];
+			s_Counters.PoolHits.fetch_add(1, std::memory_order_relaxed);
+			return block;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_GlobalCache.Mutex);
+			if (FreeBlock* block = s_GlobalCache.Heads[sizeClass]) {
+				s_GlobalCache.Heads[sizeClass] = block->Next;
+				--s_GlobalCache.Counts[sizeClass];
+				s_Counters.PoolHits.fetch_add(1, std::memory_order_relaxed);
+				return block;
+			}
+		}
+
+		s_Counters.PoolMisses.fetch_add(1, std::memory_order_relaxed);
+		return std::malloc(GetSizeClassSize(sizeClass));
+	}
+
+	static void ReleaseBlock(void* memory, uint8_t sizeClass) {
+		FreeBlock* block = static_cast<FreeBlock*>(memory);
+
+		ThreadBlockCache& cache = s_ThreadCache;
+		if (cache.Counts[sizeClass] < s_ThreadCacheLimit) {
+			block->Next = cache.Heads[sizeClass];
+			cache.Heads[sizeClass] = block;
+			++cache.Counts[sizeClass];
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_GlobalCache.Mutex);
+			if (s_GlobalCache.Counts[sizeClass] < s_GlobalCacheLimit) {
+				block->Next = s_GlobalCache.Heads[sizeClass];
+				s_GlobalCache.Heads[sizeClass] = block;
+				++s_GlobalCache.Counts[sizeClass];
+				return;
+			}
+		}
+
+		std::free(block);
+	}
+
+	static inline uint32_t ClampScope(VkSystemAllocationScope scope) {
+		return std::min(static_cast<uint32_t>(scope), VulkanAllocationScopeCount - 1);
+	}
+
+	static void* VKAPI_CALL HostAllocate(void* pUserData, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+		if (size == 0)
+			return nullptr;
+
+		alignment = std::max(alignment, alignof(HostAllocationHeader));
+		// malloc only guarantees 16 bytes, larger alignments may need padding in front of the header
+		size_t blockSize = size + sizeof(HostAllocationHeader) + (alignment - alignof(HostAllocationHeader));
+
+		uint8_t sizeClass = s_Unpooled;
+		if (alignment <= s_MaxPooledAlignment && s_PoolingEnabled.load(std::memory_order_relaxed))
+			sizeClass = FindSizeClass(blockSize);
+
+		void* block = sizeClass != s_Unpooled ? AcquireBlock(sizeClass) : std::malloc(blockSize);
+		if (!block)
+			return nullptr;
+
+		uintptr_t base = reinterpret_cast<uintptr_t>(block);
+		uintptr_t memory = (base + sizeof(HostAllocationHeader) + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+
+		HostAllocationHeader* header = reinterpret_cast<HostAllocationHeader*>(memory) - 1;
+		header->Size = size;
+		header->Offset = static_cast<uint32_t>(memory - base);
+		header->AlignmentShift = 0;
+		while ((size_t(1) << header->AlignmentShift) < alignment)
+			++header->AlignmentShift;
+		header->Scope = static_cast<uint8_t>(ClampScope(scope));
+		header->SizeClass = sizeClass;
+
+		s_Counters.LiveBytes[header->Scope].fetch_add(size, std::memory_order_relaxed);
+		s_Counters.LiveCount[header->Scope].fetch_add(1, std::memory_order_relaxed);
+		s_Counters.TotalCount[header->Scope].fetch_add(1, std::memory_order_relaxed);
+		s_Counters.TotalBytes[header->Scope].fetch_add(size, std::memory_order_relaxed);
+		return reinterpret_cast<void*>(memory);
+	}
+
+	static void VKAPI_CALL HostFree(void* pUserData, void* pMemory) {
+		if (!pMemory)
+			return;
+
+		HostAllocationHeader* header = static_cast<HostAllocationHeader*>(pMemory) - 1;
+		s_Counters.LiveBytes[header->Scope].fetch_sub(header->Size, std::memory_order_relaxed);
+		s_Counters.LiveCount[header->Scope].fetch_sub(1, std::memory_order_relaxed);
+
+		void* block = static_cast<uint8_t*>(pMemory) - header->Offset;
+		if (header->SizeClass != s_Unpooled)
+			ReleaseBlock(block, header->SizeClass);
+		else
+			std::free(block);
+	}
+
+	static void* VKAPI_CALL HostReallocate(void* pUserData, void* pOriginal, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+		if (!pOriginal)
+			return HostAllocate(pUserData, size, alignment, scope);
+		if (size == 0) {
+			HostFree(pUserData, pOriginal);
+			return nullptr;
+		}
+
+		s_Counters.Reallocations.fetch_add(1, std::memory_order_relaxed);
+
+		const HostAllocationHeader* header = static_cast<HostAllocationHeader*>(pOriginal) - 1;
+		// Same size class and alignment, the block already fits
+		if (header->SizeClass != s_Unpooled && alignment <= (size_t(1) << header->AlignmentShift)
+			&& header->Offset + size <= GetSizeClassSize(header->SizeClass)) {
+			HostAllocationHeader* mutableHeader = const_cast<HostAllocationHeader*>(header);
+			s_Counters.LiveBytes[header->Scope].fetch_add(size - header->Size, std::memory_order_relaxed);
+			mutableHeader->Size = size;
+			return pOriginal;
+		}
+
+		void* memory = HostAllocate(pUserData, size, alignment, scope);
+		if (!memory)
+			return nullptr;
+
+		std::memcpy(memory, pOriginal, std::min(static_cast<size_t>(header->Size), size));
+		HostFree(pUserData, pOriginal);
+		return memory;
+	}
+
+	static void VKAPI_CALL HostInternalAllocation(void* pUserData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope) {
+		s_Counters.InternalBytes[ClampScope(scope)].fetch_add(size, std::memory_order_relaxed);
+	}
+
+	static void VKAPI_CALL HostInternalFree(void* pUserData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope) {
+		s_Counters.InternalBytes[ClampScope(scope)].fetch_sub(size, std::memory_order_relaxed);
+	}
+
+	VkAllocationCallbacks* VulkanHostAllocator::GetCallbacks() {
+		static VkAllocationCallbacks s_Callbacks = {
+			nullptr,
+			HostAllocate,
+			HostReallocate,
+			HostFree,
+			HostInternalAllocation,
+			HostInternalFree
+		};
+		return &s_Callbacks;
+	}
+
+	void VulkanHostAllocator::SetPoolingEnabled(bool enabled) {
+		s_PoolingEnabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool VulkanHostAllocator::IsPoolingEnabled() {
+		return s_PoolingEnabled.load(std::memory_order_relaxed);
+	}
+
+	VulkanHostAllocationStats VulkanHostAllocator::GetStats() {
+		VulkanHostAllocationStats stats{};
+		for (uint32_t i = 0; i < VulkanAllocationScopeCount; ++i) {
+			stats.LiveBytes[i] = s_Counters.LiveBytes[i].load(std::memory_order_relaxed);
+			stats.LiveCount[i] = s_Counters.LiveCount[i].load(std::memory_order_relaxed);
+			stats.TotalCount[i] = s_Counters.TotalCount[i].load(std::memory_order_relaxed);
+			stats.TotalBytes[i] = s_Counters.TotalBytes[i].load(std::memory_order_relaxed);
+			stats.InternalBytes[i] = s_Counters.InternalBytes[i].load(std::memory_order_relaxed);
+		}
+		stats.Reallocations = s_Counters.Reallocations.load(std::memory_order_relaxed);
+		stats.PoolHits = s_Counters.PoolHits.load(std::memory_order_relaxed);
+		stats.PoolMisses = s_Counters.PoolMisses.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	uint64_t VulkanHostAllocator::GetTotalAllocationCount() {
+		uint64_t count = 0;
+		for (const auto& scopeCount : s_Counters.TotalCount)
+			count += scopeCount.load(std::memory_order_relaxed);
+		return count;
+	}
+
+	void VulkanHostAllocator::LogStats() {
+		VulkanHostAllocationStats stats = GetStats();
+		CHOPPER_LOG_DEBUG("Vulkan host allocations ({} reallocations, {} pool hits, {} pool misses):",
+			stats.Reallocations, stats.PoolHits, stats.PoolMisses);
+		for (uint32_t i = 0; i < VulkanAllocationScopeCount; ++i) {
+			CHOPPER_LOG_DEBUG("  {:<8} {} live ({} bytes), {} total ({} bytes), {} internal bytes",
+				GetScopeName(static_cast<VkSystemAllocationScope>(i)), stats.LiveCount[i], stats.LiveBytes[i],
+				stats.TotalCount[i], stats.TotalBytes[i], stats.InternalBytes[i]);
+		}
+	}
+
+	const char* VulkanHostAllocator::GetScopeName(VkSystemAllocationScope scope) {
+		switch (scope) {
+		case VK_SYSTEM_ALLOCATION_SCOPE_COMMAND:  return "Command";
+		case VK_SYSTEM_ALLOCATION_SCOPE_OBJECT:   return "Object";
+		case VK_SYSTEM_ALLOCATION_SCOPE_CACHE:    return "Cache";
+		case VK_SYSTEM_ALLOCATION_SCOPE_DEVICE:   return "Device";
+		case VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE: return "Instance";
+		default:                                  return "Unknown";
+		}
+	}
+
+}
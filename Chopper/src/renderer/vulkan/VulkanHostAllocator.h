@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+
+namespace Chopper {
+
+	// Indexed by VkSystemAllocationScope
+	static constexpr uint32_t VulkanAllocationScopeCount = 5;
+
+	struct VulkanHostAllocationStats {
+		std::array<uint64_t, VulkanAllocationScopeCount> LiveBytes{};
+		std::array<uint64_t, VulkanAllocationScopeCount> LiveCount{};
+		std::array<uint64_t, VulkanAllocationScopeCount> TotalCount{};
+		std::array<uint64_t, VulkanAllocationScopeCount> TotalBytes{};
+		// Reported through pfnInternalAllocation, memory the driver got without asking us
+		std::array<uint64_t, VulkanAllocationScopeCount> InternalBytes{};
+		uint64_t Reallocations = 0;
+		uint64_t PoolHits = 0;
+		uint64_t PoolMisses = 0;
+	};
+
+	// VkAllocationCallbacks recording host memory handed to the driver per allocation scope.
+	// Small blocks can be recycled through per-thread caches instead of going back to malloc.
+	class VulkanHostAllocator {
+	public:
+		static VkAllocationCallbacks* GetCallbacks();
+
+		// Safe to toggle at any time, every block remembers where it came from
+		static void SetPoolingEnabled(bool enabled);
+		static bool IsPoolingEnabled();
+
+		static VulkanHostAllocationStats GetStats();
+		static uint64_t GetTotalAllocationCount();
+		static void LogStats();
+
+		static const char* GetScopeName(VkSystemAllocationScope scope);
+	};
+
+}
@@ -35,29 +35,36 @@ namespace Chopper {
 		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+		// Relocated images are copied on the transfer queue while the graphics queue owns them
+		const PhysicalDeviceQueueFamilyDetails& queueFamilies = VulkanContext::GetDevice()->GetQueueFamilyIndices();
+		std::array<uint32_t, 2> queueFamilyIndices = { queueFamilies.GraphicsFamilyIndex, queueFamilies.TransferFamilyIndex };
+		if (customImage.Relocatable) {
+			imageCreateInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+			if (queueFamilyIndices[0] != queueFamilyIndices[1]) {
+				imageCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+				imageCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilyIndices.size());
+				imageCreateInfo.pQueueFamilyIndices = queueFamilyIndices.data();
+			}
+		}
+
 		VK_MSG_CHECK(
 			vkCreateImage(device, &imageCreateInfo, VulkanContext::GetAllocator(), &m_Image),
 			"Failed to create image!"
 		);
 
-		VkMemoryRequirements memRequirements{};
-		vkGetImageMemoryRequirements(device, m_Image, &memRequirements);
-
-		uint32_t memoryType = VulkanContext::FindMemoryType(memRequirements.memoryTypeBits, customImage.MemoryFlags);
-		if (memoryType == (uint32_t)-1)
-			CHOPPER_LOG_ERROR("Image required an unavailable memory type.");
-
-		VkMemoryAllocateInfo memAllocInfo{};
-		memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		memAllocInfo.allocationSize = memRequirements.size;
-		memAllocInfo.memoryTypeIndex = memoryType;
-
-		VK_MSG_CHECK(
-			vkAllocateMemory(device, &memAllocInfo, VulkanContext::GetAllocator(), &m_ImageMemory),
-			"Failed to allocate image memory!"
-		);
+		if (!VulkanContext::GetMemoryAllocator()->AllocateImage(m_Image, customImage.MemoryFlags, customImage.Tiling, m_Allocation)) {
+			CHOPPER_LOG_ERROR("Failed to allocate image memory!");
+			return;
+		}
 
-		vkBindImageMemory(device, m_Image, m_ImageMemory, 0);
+		m_CreateInfo = imageCreateInfo;
+		// Points into this stack frame, rebuilt from the device when the image is recreated
+		m_CreateInfo.pQueueFamilyIndices = nullptr;
+		m_MemoryFlags = customImage.MemoryFlags;
+		m_AspectFlags = customImage.ViewAspectFlags;
+		m_Relocatable = customImage.Relocatable;
+		if (m_Relocatable)
+			VulkanContext::GetDefragmenter()->Register(this);
 
 		if (customImage.CreateView)
 			CreateImageView(customImage.Format, customImage.ViewAspectFlags);
@@ -86,20 +93,22 @@ namespace Chopper {
 		VkDevice device = VulkanContext::GetDevice()->Logical();
 		VkAllocationCallbacks* allocator = VulkanContext::GetAllocator();
 
+		if (m_Relocatable) {
+			VulkanContext::GetDefragmenter()->Unregister(this);
+			m_Relocatable = false;
+		}
+
 		if (m_ImageView != VK_NULL_HANDLE) {
 			vkDestroyImageView(device, m_ImageView, allocator);
 			m_ImageView = VK_NULL_HANDLE;
 		}
 
-		if (m_ImageMemory != VK_NULL_HANDLE) {
-			vkFreeMemory(device, m_ImageMemory, allocator);
-			m_ImageMemory = VK_NULL_HANDLE;
-		}
-
 		if (m_Image != VK_NULL_HANDLE) {
 			vkDestroyImage(device, m_Image, allocator);
 			m_Image = VK_NULL_HANDLE;
 		}
+
+		VulkanContext::GetMemoryAllocator()->Free(m_Allocation);
 	}
 
 }
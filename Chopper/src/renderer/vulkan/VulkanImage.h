@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include "VulkanMemoryAllocator.h"
+
 namespace Chopper {
 
 	class VulkanImage {
@@ -16,14 +18,32 @@ namespace Chopper {
 			VkMemoryPropertyFlags MemoryFlags;
 			VkBool32 CreateView;
 			VkImageAspectFlags ViewAspectFlags;
+			// Lets the defragmenter move the image to another memory block, handles and view change
+			// when that happens, so they must not be cached across frames
+			bool Relocatable = false;
 		};
 
 		VulkanImage() = default;
 		VulkanImage(const CustomImageInfo& customImage);
 		virtual ~VulkanImage();
 
+		inline VkImage GetImage() const { return m_Image; }
+		inline VkImageView GetImageView() const { return m_ImageView; }
+		inline const VulkanAllocation& GetAllocation() const { return m_Allocation; }
+		inline uint32_t GetWidth() const { return m_Width; }
+		inline uint32_t GetHeight() const { return m_Height; }
+		inline uint32_t GetMipLevels() const { return m_CreateInfo.mipLevels; }
+		inline VkImageAspectFlags GetAspectFlags() const { return m_AspectFlags; }
+		inline bool IsConcurrent() const { return m_CreateInfo.sharingMode == VK_SHARING_MODE_CONCURRENT; }
+		inline bool IsRelocatable() const { return m_Relocatable; }
+
+		// Layout the image is left in between frames, contents are preserved on relocation unless undefined
+		inline VkImageLayout GetLayout() const { return m_Layout; }
+		inline void SetLayout(VkImageLayout layout) { m_Layout = layout; }
 
 	private:
+		friend class VulkanDefragmenter;
+
 		void Create(const CustomImageInfo& customImage);
 
 	protected:
@@ -34,8 +54,15 @@ namespace Chopper {
 		uint32_t m_Height;
 
 		VkImage m_Image = VK_NULL_HANDLE;
-		VkDeviceMemory m_ImageMemory = VK_NULL_HANDLE;
+		VulkanAllocation m_Allocation{};
 		VkImageView m_ImageView = VK_NULL_HANDLE;
+		VkImageLayout m_Layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		// Kept to recreate the image and its view when relocated
+		VkImageCreateInfo m_CreateInfo{};
+		VkMemoryPropertyFlags m_MemoryFlags = 0;
+		VkImageAspectFlags m_AspectFlags = 0;
+		bool m_Relocatable = false;
 	};
 
 }
@@ -0,0 +1,533 @@
+#include "VulkanMemoryAllocator.h"
+
+#include "VulkanContext.h"
+
+#include <core/Logger.h>
+
+namespace Chopper {
+
+	static constexpr VkDeviceSize s_SmallHeapSize = 1024ull * 1024 * 1024;
+	static constexpr VkDeviceSize s_MinBlockSize = 1024 * 1024;
+	static constexpr VkDeviceSize s_BarWindowSize = 256ull * 1024 * 1024;
+
+	static uint32_t Log2(VkDeviceSize value) {
+		uint32_t result = 0;
+		while (value >>= 1)
+			++result;
+		return result;
+	}
+
+	// Buddy allocator over one VkDeviceMemory. Nodes form an implicit binary tree, node 1 is
+	// the whole block and the children of node n are 2n and 2n + 1.
+	class VulkanMemoryBlock {
+	public:
+		VulkanMemoryBlock(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryType, VulkanResourceTiling tiling, void* mappedData)
+			: Memory(memory), Size(size), MemoryType(memoryType), Tiling(tiling), MappedData(mappedData) {
+			m_LevelCount = Log2(size / VulkanMemoryAllocator::MinAllocationSize) + 1;
+			m_States.assign(static_cast<size_t>(1) << m_LevelCount, NodeUnused);
+			m_FreePositions.resize(m_States.size());
+			m_FreeLists.resize(m_LevelCount);
+			PushFree(1, 0);
+		}
+
+		bool Allocate(VkDeviceSize size, uint32_t& node, VkDeviceSize& offset) {
+			uint32_t level = 0;
+			uint32_t freeLevel = 0;
+			if (!FindLevels(size, level, freeLevel))
+				return false;
+
+			node = m_FreeLists[freeLevel].back();
+			RemoveFree(node, freeLevel);
+			for (; freeLevel < level; ++freeLevel) {
+				m_States[node] = NodeSplit;
+				PushFree(2 * node + 1, freeLevel + 1);
+				node = 2 * node;
+			}
+			m_States[node] = NodeAllocated;
+
+			offset = GetNodeOffset(node);
+			UsedBytes += GetNodeSize(node);
+			++AllocationCount;
+			return true;
+		}
+
+		inline bool HasRoom(VkDeviceSize size) const {
+			uint32_t level = 0;
+			uint32_t freeLevel = 0;
+			return FindLevels(size, level, freeLevel);
+		}
+
+		void Free(uint32_t node) {
+			CHOPPER_ASSERT(m_States[node] == NodeAllocated, "Freeing a Vulkan memory range that is not allocated!");
+			UsedBytes -= GetNodeSize(node);
+			--AllocationCount;
+
+			uint32_t level = Log2(node);
+			while (node > 1 && m_States[node ^ 1] == NodeFree) {
+				RemoveFree(node ^ 1, level);
+				m_States[node ^ 1] = NodeUnused;
+				m_States[node] = NodeUnused;
+				node >>= 1;
+				--level;
+			}
+			PushFree(node, level);
+		}
+
+		inline VkDeviceSize GetNodeSize(uint32_t node) const { return Size >> Log2(node); }
+		inline VkDeviceSize GetNodeOffset(uint32_t node) const {
+			uint32_t level = Log2(node);
+			return (node - (1u << level)) * (Size >> level);
+		}
+
+		VkDeviceSize GetLargestFreeRange() const {
+			for (uint32_t level = 0; level < m_LevelCount; ++level)
+				if (!m_FreeLists[level].empty())
+					return Size >> level;
+			return 0;
+		}
+
+		inline bool IsEmpty() const { return AllocationCount == 0; }
+
+		VkDeviceMemory Memory;
+		VkDeviceSize Size;
+		uint32_t MemoryType;
+		VulkanResourceTiling Tiling;
+		void* MappedData;
+
+		VkDeviceSize UsedBytes = 0;
+		VkDeviceSize RequestedBytes = 0;
+		uint32_t AllocationCount = 0;
+
+	private:
+		enum NodeState : uint8_t {
+			NodeUnused,
+			NodeFree,
+			NodeSplit,
+			NodeAllocated
+		};
+
+		// Level of the node a size needs and the deepest level above it with a free node to split
+		bool FindLevels(VkDeviceSize size, uint32_t& level, uint32_t& freeLevel) const {
+			level = m_LevelCount - 1;
+			while (level > 0 && (Size >> level) < size)
+				--level;
+			if ((Size >> level) < size)
+				return false;
+
+			freeLevel = level + 1;
+			while (freeLevel > 0 && m_FreeLists[freeLevel - 1].empty())
+				--freeLevel;
+			if (freeLevel == 0)
+				return false;
+			--freeLevel;
+			return true;
+		}
+
+		void PushFree(uint32_t node, uint32_t level) {
+			m_States[node] = NodeFree;
+			m_FreePositions[node] = static_cast<uint32_t>(m_FreeLists[level].size());
+			m_FreeLists[level].push_back(node);
+		}
+
+		void RemoveFree(uint32_t node, uint32_t level) {
+			std::vector<uint32_t>& freeList = m_FreeLists[level];
+			uint32_t last = freeList.back();
+			freeList[m_FreePositions[node]] = last;
+			m_FreePositions[last] = m_FreePositions[node];
+			freeList.pop_back();
+		}
+
+		uint32_t m_LevelCount;
+		std::vector<uint8_t> m_States;
+		// Index of every free node within the free list of its level, for O(1) removal when merging
+		std::vector<uint32_t> m_FreePositions;
+		std::vector<std::vector<uint32_t>> m_FreeLists;
+	};
+
+	float VulkanMemoryStats::GetExternalFragmentation() const {
+		VkDeviceSize freeBytes = BlockBytes - UsedBytes;
+		if (freeBytes == 0)
+			return 0.0f;
+		return 1.0f - static_cast<float>(LargestFreeRange) / static_cast<float>(freeBytes);
+	}
+
+	float VulkanMemoryStats::GetInternalFragmentation() const {
+		VkDeviceSize usedBytes = UsedBytes + DedicatedBytes;
+		if (usedBytes == 0)
+			return 0.0f;
+		return 1.0f - static_cast<float>(RequestedBytes) / static_cast<float>(usedBytes);
+	}
+
+	VulkanMemoryAllocator::VulkanMemoryAllocator() = default;
+	VulkanMemoryAllocator::~VulkanMemoryAllocator() = default;
+
+	bool VulkanMemoryAllocator::CreateAllocator() {
+		VkPhysicalDevice physicalDevice = VulkanContext::GetDevice()->Physical();
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_MemoryProperties);
+		m_MaxDeviceAllocationCount = VulkanContext::GetDevice()->GetProperties().limits.maxMemoryAllocationCount;
+		m_DeviceAllocationCount = 0;
+
+		m_ResizableBar = false;
+		VkMemoryPropertyFlags barFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+		for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; ++i) {
+			const VkMemoryType& memoryType = m_MemoryProperties.memoryTypes[i];
+			if ((memoryType.propertyFlags & barFlags) == barFlags && m_MemoryProperties.memoryHeaps[memoryType.heapIndex].size > s_BarWindowSize)
+				m_ResizableBar = true;
+		}
+
+		CHOPPER_LOG_DEBUG("Vulkan Memory Allocator created, {} memory types, {} device allocations at most{}.",
+			m_MemoryProperties.memoryTypeCount, m_MaxDeviceAllocationCount, m_ResizableBar ? ", resizable BAR" : "");
+		return true;
+	}
+
+	void VulkanMemoryAllocator::ReleaseAllocator() {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		CHOPPER_LOG_DEBUG("Destroying Vulkan Memory Allocator...");
+		for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; ++i) {
+			MemoryType& memoryType = m_MemoryTypes[i];
+			for (Pool& pool : memoryType.Pools) {
+				for (std::unique_ptr<VulkanMemoryBlock>& block : pool.Blocks) {
+					if (!block->IsEmpty())
+						CHOPPER_LOG_WARN("Vulkan memory block released with {} live allocations.", block->AllocationCount);
+					DestroyBlock(block.get());
+				}
+				pool.Blocks.clear();
+			}
+			if (memoryType.DedicatedCount)
+				CHOPPER_LOG_WARN("{} dedicated Vulkan allocations of memory type {} were never freed.", memoryType.DedicatedCount, i);
+			memoryType = MemoryType{};
+		}
+	}
+
+	bool VulkanMemoryAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, VulkanResourceTiling tiling,
+		VulkanAllocation& allocation, bool dedicated, VkMemoryPropertyFlags preferredProperties, VkMemoryPropertyFlags avoidedProperties) {
+		uint32_t memoryType = FindMemoryType(requirements.memoryTypeBits, properties, preferredProperties, avoidedProperties);
+		if (memoryType == (uint32_t)-1) {
+			CHOPPER_LOG_ERROR("No Vulkan memory type matches the requested properties.");
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// Nodes are aligned to their own size, rounding up to the alignment is enough
+		VkDeviceSize size = std::max(requirements.size, requirements.alignment);
+		VkDeviceSize blockSize = GetBlockSize(memoryType);
+		if (dedicated || size > blockSize / 2)
+			return AllocateDedicated(requirements, memoryType, allocation);
+
+		Pool& pool = m_MemoryTypes[memoryType].Pools[static_cast<size_t>(tiling)];
+		uint32_t node = 0;
+		VkDeviceSize offset = 0;
+		VulkanMemoryBlock* block = nullptr;
+		for (std::unique_ptr<VulkanMemoryBlock>& candidate : pool.Blocks) {
+			if (candidate->Allocate(size, node, offset)) {
+				block = candidate.get();
+				break;
+			}
+		}
+
+		if (!block) {
+			block = CreateBlock(memoryType, tiling, blockSize);
+			if (!block)
+				return false;
+			pool.Blocks.emplace_back(block);
+			block->Allocate(size, node, offset);
+		}
+
+		FillAllocation(block, requirements, node, offset, allocation);
+		return true;
+	}
+
+	bool VulkanMemoryAllocator::Reallocate(const VkMemoryRequirements& requirements, const VulkanAllocation& current, VulkanAllocation& allocation) {
+		if (!current.Block || !(requirements.memoryTypeBits & (1u << current.MemoryType)))
+			return false;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		VkDeviceSize size = std::max(requirements.size, requirements.alignment);
+		Pool& pool = m_MemoryTypes[current.MemoryType].Pools[static_cast<size_t>(current.Block->Tiling)];
+		for (std::unique_ptr<VulkanMemoryBlock>& block : pool.Blocks) {
+			if (block.get() == current.Block || block->UsedBytes <= current.Block->UsedBytes)
+				continue;
+
+			uint32_t node = 0;
+			VkDeviceSize offset = 0;
+			if (block->Allocate(size, node, offset)) {
+				FillAllocation(block.get(), requirements, node, offset, allocation);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool VulkanMemoryAllocator::CanReallocate(const VkMemoryRequirements& requirements, const VulkanAllocation& current) const {
+		if (!current.Block || !(requirements.memoryTypeBits & (1u << current.MemoryType)))
+			return false;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		VkDeviceSize size = std::max(requirements.size, requirements.alignment);
+		const Pool& pool = m_MemoryTypes[current.MemoryType].Pools[static_cast<size_t>(current.Block->Tiling)];
+		for (const std::unique_ptr<VulkanMemoryBlock>& block : pool.Blocks) {
+			if (block.get() == current.Block || block->UsedBytes <= current.Block->UsedBytes)
+				continue;
+			if (block->HasRoom(size))
+				return true;
+		}
+		return false;
+	}
+
+	uint64_t VulkanMemoryAllocator::GetGeneration() const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Generation;
+	}
+
+	VulkanMemoryBlockInfo VulkanMemoryAllocator::GetBlockInfo(const VulkanMemoryBlock* block) const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		VulkanMemoryBlockInfo info{};
+		info.Size = block->Size;
+		info.UsedBytes = block->UsedBytes;
+		info.AllocationCount = block->AllocationCount;
+		info.PoolBlockCount = static_cast<uint32_t>(m_MemoryTypes[block->MemoryType].Pools[static_cast<size_t>(block->Tiling)].Blocks.size());
+		return info;
+	}
+
+	void VulkanMemoryAllocator::Free(VulkanAllocation& allocation) {
+		if (!allocation.IsValid())
+			return;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		++m_Generation;
+
+		MemoryType& memoryType = m_MemoryTypes[allocation.MemoryType];
+		if (allocation.IsDedicated()) {
+			vkFreeMemory(VulkanContext::GetDevice()->Logical(), allocation.Memory, VulkanContext::GetAllocator());
+			--m_DeviceAllocationCount;
+			--memoryType.DedicatedCount;
+			memoryType.DedicatedBytes -= allocation.Size;
+			allocation = VulkanAllocation{};
+			return;
+		}
+
+		VulkanMemoryBlock* block = allocation.Block;
+		block->Free(allocation.Node);
+		block->RequestedBytes -= allocation.Size;
+
+		// One empty block per pool is kept around, freeing the last resource should not free the memory
+		Pool& pool = memoryType.Pools[static_cast<size_t>(block->Tiling)];
+		if (block->IsEmpty() && pool.Blocks.size() > 1) {
+			auto it = std::find_if(pool.Blocks.begin(), pool.Blocks.end(),
+				[block](const std::unique_ptr<VulkanMemoryBlock>& candidate) { return candidate.get() == block; });
+			m_ReleasedBytes += block->Size;
+			DestroyBlock(block);
+			pool.Blocks.erase(it);
+		}
+
+		allocation = VulkanAllocation{};
+	}
+
+	bool VulkanMemoryAllocator::AllocateImage(VkImage image, VkMemoryPropertyFlags properties, VkImageTiling tiling, VulkanAllocation& allocation) {
+		VkDevice device = VulkanContext::GetDevice()->Logical();
+
+		VkMemoryRequirements requirements{};
+		vkGetImageMemoryRequirements(device, image, &requirements);
+
+		VulkanResourceTiling resourceTiling = tiling == VK_IMAGE_TILING_OPTIMAL ? VulkanResourceTiling::Optimal : VulkanResourceTiling::Linear;
+		if (!Allocate(requirements, properties, resourceTiling, allocation))
+			return false;
+
+		if (vkBindImageMemory(device, image, allocation.Memory, allocation.Offset) != VK_SUCCESS) {
+			CHOPPER_LOG_ERROR("Failed to bind image memory!");
+			Free(allocation);
+			return false;
+		}
+		return true;
+	}
+
+	bool VulkanMemoryAllocator::AllocateBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties, VulkanAllocation& allocation, VkMemoryPropertyFlags preferredProperties,
+		VkMemoryPropertyFlags avoidedProperties) {
+		VkDevice device = VulkanContext::GetDevice()->Logical();
+
+		VkMemoryRequirements requirements{};
+		vkGetBufferMemoryRequirements(device, buffer, &requirements);
+
+		if (!Allocate(requirements, properties, VulkanResourceTiling::Linear, allocation, false, preferredProperties, avoidedProperties))
+			return false;
+
+		if (vkBindBufferMemory(device, buffer, allocation.Memory, allocation.Offset) != VK_SUCCESS) {
+			CHOPPER_LOG_ERROR("Failed to bind buffer memory!");
+			Free(allocation);
+			return false;
+		}
+		return true;
+	}
+
+	uint32_t VulkanMemoryAllocator::FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred,
+		VkMemoryPropertyFlags avoided) const {
+		uint32_t best = (uint32_t)-1;
+		uint32_t bestScore = 0;
+		for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; ++i) {
+			VkMemoryPropertyFlags flags = m_MemoryProperties.memoryTypes[i].propertyFlags;
+			if (!(typeBits & (1u << i)) || (flags & required) != required)
+				continue;
+
+			uint32_t score = 1 + ((flags & avoided) == 0 ? 2 : 0) + ((flags & preferred) == preferred ? 1 : 0);
+			if (score > bestScore) {
+				best = i;
+				bestScore = score;
+			}
+		}
+		return best;
+	}
+
+	VulkanMemoryStats VulkanMemoryAllocator::GetStats() const {
+		VulkanMemoryStats total{};
+		for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; ++i) {
+			VulkanMemoryStats stats = GetStats(i);
+			total.BlockCount += stats.BlockCount;
+			total.AllocationCount += stats.AllocationCount;
+			total.DedicatedCount += stats.DedicatedCount;
+			total.BlockBytes += stats.BlockBytes;
+			total.UsedBytes += stats.UsedBytes;
+			total.RequestedBytes += stats.RequestedBytes;
+			total.DedicatedBytes += stats.DedicatedBytes;
+			total.LargestFreeRange = std::max(total.LargestFreeRange, stats.LargestFreeRange);
+		}
+		return total;
+	}
+
+	VulkanMemoryStats VulkanMemoryAllocator::GetStats(uint32_t memoryType) const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		VulkanMemoryStats stats{};
+		const MemoryType& type = m_MemoryTypes[memoryType];
+		for (const Pool& pool : type.Pools) {
+			for (const std::unique_ptr<VulkanMemoryBlock>& block : pool.Blocks) {
+				++stats.BlockCount;
+				stats.AllocationCount += block->AllocationCount;
+				stats.BlockBytes += block->Size;
+				stats.UsedBytes += block->UsedBytes;
+				stats.RequestedBytes += block->RequestedBytes;
+				stats.LargestFreeRange = std::max(stats.LargestFreeRange, block->GetLargestFreeRange());
+			}
+		}
+		stats.AllocationCount += type.DedicatedCount;
+		stats.DedicatedCount = type.DedicatedCount;
+		stats.DedicatedBytes = type.DedicatedBytes;
+		stats.RequestedBytes += type.DedicatedBytes;
+		return stats;
+	}
+
+	void VulkanMemoryAllocator::LogStats() const {
+		CHOPPER_LOG_INFO("Vulkan device memory, {} of {} device allocations in use:", m_DeviceAllocationCount, m_MaxDeviceAllocationCount);
+		for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; ++i) {
+			VulkanMemoryStats stats = GetStats(i);
+			if (stats.BlockCount == 0 && stats.DedicatedCount == 0)
+				continue;
+
+			CHOPPER_LOG_INFO("  Type {} (flags 0x{:x}): {} blocks ({:.1f} MiB, {:.1f} MiB used), {} allocations, {} dedicated ({:.1f} MiB), "
+				"fragmentation {:.0f}% external, {:.0f}% internal",
+				i, m_MemoryProperties.memoryTypes[i].propertyFlags, stats.BlockCount,
+				stats.BlockBytes / (1024.0 * 1024.0), stats.UsedBytes / (1024.0 * 1024.0),
+				stats.AllocationCount, stats.DedicatedCount, stats.DedicatedBytes / (1024.0 * 1024.0),
+				stats.GetExternalFragmentation() * 100.0f, stats.GetInternalFragmentation() * 100.0f);
+		}
+	}
+
+	VulkanMemoryBlock* VulkanMemoryAllocator::CreateBlock(uint32_t memoryType, VulkanResourceTiling tiling, VkDeviceSize size) {
+		if (m_DeviceAllocationCount >= m_MaxDeviceAllocationCount) {
+			CHOPPER_LOG_ERROR("Reached maxMemoryAllocationCount ({}), cannot allocate more Vulkan device memory!", m_MaxDeviceAllocationCount);
+			return nullptr;
+		}
+
+		VkDevice device = VulkanContext::GetDevice()->Logical();
+
+		VkMemoryAllocateInfo allocateInfo{};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocateInfo.allocationSize = size;
+		allocateInfo.memoryTypeIndex = memoryType;
+
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		if (vkAllocateMemory(device, &allocateInfo, VulkanContext::GetAllocator(), &memory) != VK_SUCCESS) {
+			CHOPPER_LOG_ERROR("Failed to allocate a Vulkan memory block of {} bytes!", size);
+			return nullptr;
+		}
+		++m_DeviceAllocationCount;
+
+		void* mappedData = nullptr;
+		if (m_MemoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+			vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &mappedData);
+
+		CHOPPER_LOG_DEBUG("Vulkan memory block of {:.1f} MiB allocated from memory type {}.", size / (1024.0 * 1024.0), memoryType);
+		return new VulkanMemoryBlock(memory, size, memoryType, tiling, mappedData);
+	}
+
+	void VulkanMemoryAllocator::DestroyBlock(VulkanMemoryBlock* block) {
+		// Freeing implicitly unmaps
+		vkFreeMemory(VulkanContext::GetDevice()->Logical(), block->Memory, VulkanContext::GetAllocator());
+		--m_DeviceAllocationCount;
+	}
+
+	bool VulkanMemoryAllocator::AllocateDedicated(const VkMemoryRequirements& requirements, uint32_t memoryType, VulkanAllocation& allocation) {
+		if (m_DeviceAllocationCount >= m_MaxDeviceAllocationCount) {
+			CHOPPER_LOG_ERROR("Reached maxMemoryAllocationCount ({}), cannot allocate more Vulkan device memory!", m_MaxDeviceAllocationCount);
+			return false;
+		}
+
+		VkDevice device = VulkanContext::GetDevice()->Logical();
+
+		VkMemoryAllocateInfo allocateInfo{};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocateInfo.allocationSize = requirements.size;
+		allocateInfo.memoryTypeIndex = memoryType;
+
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		if (vkAllocateMemory(device, &allocateInfo, VulkanContext::GetAllocator(), &memory) != VK_SUCCESS) {
+			CHOPPER_LOG_ERROR("Failed to allocate {} bytes of dedicated Vulkan memory!", requirements.size);
+			return false;
+		}
+		++m_DeviceAllocationCount;
+
+		MemoryType& type = m_MemoryTypes[memoryType];
+		++type.DedicatedCount;
+		type.DedicatedBytes += requirements.size;
+
+		void* mappedData = nullptr;
+		if (m_MemoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+			vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &mappedData);
+
+		allocation.Memory = memory;
+		allocation.Offset = 0;
+		allocation.Size = requirements.size;
+		allocation.MappedData = mappedData;
+		allocation.MemoryType = memoryType;
+		allocation.Block = nullptr;
+		allocation.Node = 0;
+		return true;
+	}
+
+	void VulkanMemoryAllocator::FillAllocation(VulkanMemoryBlock* block, const VkMemoryRequirements& requirements, uint32_t node, VkDeviceSize offset,
+		VulkanAllocation& allocation) {
+		block->RequestedBytes += requirements.size;
+		++m_Generation;
+
+		allocation.Memory = block->Memory;
+		allocation.Offset = offset;
+		allocation.Size = requirements.size;
+		allocation.MappedData = block->MappedData ? static_cast<unsigned char*>(block->MappedData) + offset : nullptr;
+		allocation.MemoryType = block->MemoryType;
+		allocation.Block = block;
+		allocation.Node = node;
+	}
+
+	VkDeviceSize VulkanMemoryAllocator::GetBlockSize(uint32_t memoryType) const {
+		// Small heaps (integrated GPUs, the 256 MiB BAR window) get blocks of an eighth of the heap
+		VkDeviceSize heapSize = m_MemoryProperties.memoryHeaps[m_MemoryProperties.memoryTypes[memoryType].heapIndex].size;
+		if (heapSize > s_SmallHeapSize)
+			return DefaultBlockSize;
+		return std::max(static_cast<VkDeviceSize>(1) << Log2(heapSize / 8), s_MinBlockSize);
+	}
+
+}
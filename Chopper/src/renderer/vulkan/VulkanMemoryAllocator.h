@@ -0,0 +1,142 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+namespace Chopper {
+
+	// Linear resources (buffers, linear images) and optimal images never share a block, so
+	// bufferImageGranularity never has to be accounted for between neighbours
+	enum class VulkanResourceTiling {
+		Linear,
+		Optimal,
+		Count
+	};
+
+	class VulkanMemoryBlock;
+
+	struct VulkanAllocation {
+		VkDeviceMemory Memory = VK_NULL_HANDLE;
+		VkDeviceSize Offset = 0;
+		VkDeviceSize Size = 0;
+		// Persistently mapped pointer to Offset, null unless the memory is host visible
+		void* MappedData = nullptr;
+
+		uint32_t MemoryType = (uint32_t)-1;
+		// Null for dedicated allocations
+		VulkanMemoryBlock* Block = nullptr;
+		uint32_t Node = 0;
+
+		inline bool IsValid() const { return Memory != VK_NULL_HANDLE; }
+		inline bool IsDedicated() const { return Memory != VK_NULL_HANDLE && !Block; }
+	};
+
+	struct VulkanMemoryBlockInfo {
+		VkDeviceSize Size = 0;
+		VkDeviceSize UsedBytes = 0;
+		uint32_t AllocationCount = 0;
+		// Blocks in the same memory type and tiling pool, including this one
+		uint32_t PoolBlockCount = 0;
+	};
+
+	struct VulkanMemoryStats {
+		uint32_t BlockCount = 0;
+		uint32_t AllocationCount = 0;
+		uint32_t DedicatedCount = 0;
+		VkDeviceSize BlockBytes = 0;
+		// Rounded up to the buddy sizes, so includes internal fragmentation
+		VkDeviceSize UsedBytes = 0;
+		// Bytes actually requested
+		VkDeviceSize RequestedBytes = 0;
+		VkDeviceSize DedicatedBytes = 0;
+		VkDeviceSize LargestFreeRange = 0;
+
+		// 1 - largest free range / free bytes, 0 when all free memory is contiguous
+		float GetExternalFragmentation() const;
+		// Share of the used bytes lost to rounding up to powers of two
+		float GetInternalFragmentation() const;
+	};
+
+	// Device memory sub-allocator. Large blocks are allocated per memory type and resource
+	// tiling, then split with a buddy scheme, so every sub-allocation is aligned to its own
+	// rounded up size. Requests larger than half a block get a dedicated allocation.
+	class VulkanMemoryAllocator {
+		friend class VulkanContext;
+	public:
+		VulkanMemoryAllocator();
+		~VulkanMemoryAllocator();
+
+		static constexpr VkDeviceSize MinAllocationSize = 1024;
+		static constexpr VkDeviceSize DefaultBlockSize = 64ull * 1024 * 1024;
+
+		// Preferred properties are used when a memory type has them on top of the required ones,
+		// avoided ones only when every matching type has them
+		bool Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, VulkanResourceTiling tiling,
+			VulkanAllocation& allocation, bool dedicated = false, VkMemoryPropertyFlags preferredProperties = 0, VkMemoryPropertyFlags avoidedProperties = 0);
+		void Free(VulkanAllocation& allocation);
+
+		// Allocate and bind in one go
+		bool AllocateImage(VkImage image, VkMemoryPropertyFlags properties, VkImageTiling tiling, VulkanAllocation& allocation);
+		bool AllocateBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties, VulkanAllocation& allocation, VkMemoryPropertyFlags preferredProperties = 0,
+			VkMemoryPropertyFlags avoidedProperties = 0);
+
+		// Moves into another block of the same pool that is fuller than the current one, never creates
+		// a block. Used by the defragmenter to empty sparse blocks.
+		bool Reallocate(const VkMemoryRequirements& requirements, const VulkanAllocation& current, VulkanAllocation& allocation);
+		// Whether Reallocate would find room, without allocating anything
+		bool CanReallocate(const VkMemoryRequirements& requirements, const VulkanAllocation& current) const;
+		// Changes with every allocation and free, lets callers skip work until the blocks changed
+		uint64_t GetGeneration() const;
+		VulkanMemoryBlockInfo GetBlockInfo(const VulkanMemoryBlock* block) const;
+		// Total size of the blocks given back to the driver once they became empty
+		inline VkDeviceSize GetReleasedBytes() const { return m_ReleasedBytes; }
+
+		// Memory type with all required flags. Types without any avoided flag come first, then those
+		// that also have the preferred ones.
+		uint32_t FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred = 0, VkMemoryPropertyFlags avoided = 0) const;
+		inline VkMemoryPropertyFlags GetMemoryTypeFlags(uint32_t memoryType) const { return m_MemoryProperties.memoryTypes[memoryType].propertyFlags; }
+		// Device local memory is host visible beyond the legacy 256 MiB BAR window
+		inline bool HasResizableBar() const { return m_ResizableBar; }
+
+		VulkanMemoryStats GetStats() const;
+		VulkanMemoryStats GetStats(uint32_t memoryType) const;
+		void LogStats() const;
+
+	private:
+		bool CreateAllocator();
+		void ReleaseAllocator();
+
+		VulkanMemoryBlock* CreateBlock(uint32_t memoryType, VulkanResourceTiling tiling, VkDeviceSize size);
+		void DestroyBlock(VulkanMemoryBlock* block);
+		bool AllocateDedicated(const VkMemoryRequirements& requirements, uint32_t memoryType, VulkanAllocation& allocation);
+		VkDeviceSize GetBlockSize(uint32_t memoryType) const;
+		void FillAllocation(VulkanMemoryBlock* block, const VkMemoryRequirements& requirements, uint32_t node, VkDeviceSize offset, VulkanAllocation& allocation);
+
+		struct Pool {
+			std::vector<std::unique_ptr<VulkanMemoryBlock>> Blocks;
+		};
+
+		struct MemoryType {
+			std::array<Pool, static_cast<size_t>(VulkanResourceTiling::Count)> Pools;
+			uint32_t DedicatedCount = 0;
+			VkDeviceSize DedicatedBytes = 0;
+		};
+
+		VkPhysicalDeviceMemoryProperties m_MemoryProperties{};
+		std::array<MemoryType, VK_MAX_MEMORY_TYPES> m_MemoryTypes;
+
+		// Every vkAllocateMemory counts against maxMemoryAllocationCount
+		uint32_t m_DeviceAllocationCount = 0;
+		uint32_t m_MaxDeviceAllocationCount = 0;
+		VkDeviceSize m_ReleasedBytes = 0;
+		uint64_t m_Generation = 0;
+		bool m_ResizableBar = false;
+
+		mutable std::mutex m_Mutex;
+	};
+
+}
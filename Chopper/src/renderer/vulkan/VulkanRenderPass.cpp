@@ -72,14 +72,12 @@ namespace Chopper {
 		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 		// dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 		dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT; // TODO: Temporary. Just for the sake of ImGui integration
-		std::vector<VkAttachmentDescription> attachments = { colorAttachment };
-		if (addDepthAtt) {
-			attachments.push_back(depthAttachment);
-		}
+		std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
+		uint32_t attachmentCount = addDepthAtt ? 2 : 1;
 
 		VkRenderPassCreateInfo renderPassCreateInfo{};
 		renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-		renderPassCreateInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		renderPassCreateInfo.attachmentCount = attachmentCount;
 		renderPassCreateInfo.pAttachments = attachments.data();
 		renderPassCreateInfo.subpassCount = 1;
 		renderPassCreateInfo.pSubpasses = &subpass;
@@ -0,0 +1,167 @@
+#include "VulkanStagingRing.h"
+
+#include "VulkanContext.h"
+
+#include <core/Logger.h>
+#include <core/Profiler.h>
+
+#include <cstring>
+
+namespace Chopper {
+
+	// Keeps every chunk at a friendly offset for the copy engines
+	static constexpr VkDeviceSize s_ChunkAlignment = 16;
+
+	// Where destination buffers are read by the frames
+	static constexpr VkPipelineStageFlags s_ConsumerStages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+		| VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+	bool VulkanStagingRing::CreateStagingRing(VkDeviceSize capacity, uint32_t framesInFlight) {
+		capacity = (capacity + s_ChunkAlignment - 1) / s_ChunkAlignment * s_ChunkAlignment;
+		if (!m_Buffer.Create(capacity, VulkanBufferUsage::Staging)) {
+			CHOPPER_LOG_ERROR("Failed to create the staging ring buffer!");
+			return false;
+		}
+
+		// The staging preset picks write-combined system memory whenever the device has some
+		VkMemoryPropertyFlags memoryFlags = VulkanContext::GetMemoryAllocator()->GetMemoryTypeFlags(m_Buffer.GetAllocation().MemoryType);
+		if (memoryFlags & (VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+			CHOPPER_LOG_DEBUG("Staging ring fell back to {} memory, no write-combined system memory type was found.",
+				memoryFlags & VK_MEMORY_PROPERTY_HOST_CACHED_BIT ? "host cached" : "device local");
+
+		m_Capacity = capacity;
+		m_FrameBudget = capacity / framesInFlight;
+		m_Head = 0;
+		m_Tail = 0;
+		m_Frames.assign(framesInFlight, FrameSlot{});
+		m_CurrentFrame = 0;
+
+		CHOPPER_LOG_DEBUG("Vulkan Staging Ring created, {} KiB.", m_Capacity / 1024);
+		return true;
+	}
+
+	void VulkanStagingRing::ReleaseStagingRing() {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_Pending.empty())
+			CHOPPER_LOG_WARN("{} uploads were still pending when the staging ring was released.", m_Pending.size());
+
+		CHOPPER_LOG_DEBUG("Destroying Vulkan Staging Ring...");
+		m_Buffer.Release();
+		m_Pending.clear();
+		m_Frames.clear();
+		m_Capacity = 0;
+	}
+
+	uint64_t VulkanStagingRing::Upload(const void* data, VkDeviceSize size, const VulkanBuffer& destination, VkDeviceSize destinationOffset) {
+		CHOPPER_ASSERT(destinationOffset + size <= destination.GetSize(), "Staged upload out of bounds!");
+
+		// Nothing to copy, reported complete right away
+		if (size == 0)
+			return 0;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		uint64_t id = m_NextUpload++;
+		m_Pending.push_back({ id, static_cast<const unsigned char*>(data), size, 0, destination.GetHandle(), destinationOffset });
+		return id;
+	}
+
+	bool VulkanStagingRing::IsComplete(uint64_t upload) const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return upload <= m_CompletedUpload;
+	}
+
+	VkDeviceSize VulkanStagingRing::GetPendingBytes() const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		VkDeviceSize bytes = 0;
+		for (const PendingUpload& upload : m_Pending)
+			bytes += upload.Size - upload.Copied;
+		return bytes;
+	}
+
+	void VulkanStagingRing::BeginFrame(uint32_t frame) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		// The swapchain may come back with more images
+		if (frame >= m_Frames.size())
+			m_Frames.resize(frame + 1);
+
+		// Frames complete in order, so the slot's head is never behind the tail
+		const FrameSlot& slot = m_Frames[frame];
+		m_Tail = std::max(m_Tail, slot.Head);
+		m_CompletedUpload = std::max(m_CompletedUpload, slot.LastUpload);
+		m_CurrentFrame = frame;
+	}
+
+	VkDeviceSize VulkanStagingRing::Allocate(VkDeviceSize size, VkDeviceSize& offset) {
+		VkDeviceSize free = m_Capacity - (m_Head - m_Tail);
+		VkDeviceSize position = m_Head % m_Capacity;
+		VkDeviceSize allocated = std::min(size, std::min(free, m_Capacity - position));
+		if (allocated == 0)
+			return 0;
+
+		offset = position;
+		m_Head = (m_Head + allocated + s_ChunkAlignment - 1) / s_ChunkAlignment * s_ChunkAlignment;
+		return allocated;
+	}
+
+	void VulkanStagingRing::Record(VkCommandBuffer commandBuffer) {
+		CHOPPER_PROFILE_FUNCTION();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_Pending.empty() || m_Capacity == 0)
+			return;
+
+		VkBuffer stagingBuffer = m_Buffer.GetHandle();
+		unsigned char* mappedData = static_cast<unsigned char*>(m_Buffer.GetMappedData());
+		VkDeviceSize budget = m_FrameBudget;
+		bool coherent = m_Buffer.IsCoherent();
+		bool recorded = false;
+
+		while (!m_Pending.empty() && budget > 0) {
+			PendingUpload& upload = m_Pending.front();
+
+			VkDeviceSize offset;
+			VkDeviceSize size = Allocate(std::min(upload.Size - upload.Copied, budget), offset);
+			if (size == 0)
+				break;
+
+			std::memcpy(mappedData + offset, upload.Data + upload.Copied, size);
+
+			// A previous frame may still be reading the destinations, write-after-read only needs the execution dependency
+			if (!recorded)
+				vkCmdPipelineBarrier(commandBuffer, s_ConsumerStages, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+			VkBufferCopy region{};
+			region.srcOffset = offset;
+			region.dstOffset = upload.DestinationOffset + upload.Copied;
+			region.size = size;
+			vkCmdCopyBuffer(commandBuffer, stagingBuffer, upload.Destination, 1, &region);
+			if (!coherent)
+				m_FlushBatch.Add(m_Buffer.GetAllocation(), offset, size);
+			recorded = true;
+
+			budget -= size;
+			upload.Copied += size;
+			if (upload.Copied == upload.Size) {
+				m_RecordedUpload = upload.Id;
+				m_Pending.pop_front();
+			}
+		}
+
+		if (recorded) {
+			if (!m_FlushBatch.Flush())
+				CHOPPER_LOG_ERROR("Failed to flush the staging ring!");
+
+			VkMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT
+				| VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, s_ConsumerStages, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+		}
+
+		FrameSlot& slot = m_Frames[m_CurrentFrame];
+		slot.Head = m_Head;
+		slot.LastUpload = m_RecordedUpload;
+	}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include "VulkanBuffer.h"
+
+#include <deque>
+#include <vector>
+#include <mutex>
+
+namespace Chopper {
+
+	// Streams buffer uploads through one persistently mapped staging buffer used as a ring.
+	// Copies are recorded into the frame's command buffer, each frame slot remembers how far
+	// the ring was written and that space is reclaimed once the slot's fence signaled.
+	// Uploads larger than what is free, or than the per-frame budget, spill over several frames.
+	class VulkanStagingRing {
+		friend class VulkanContext;
+	public:
+		static constexpr VkDeviceSize DefaultCapacity = 32ull * 1024 * 1024;
+
+		// Source data must stay valid until the upload is complete, the destination as well
+		uint64_t Upload(const void* data, VkDeviceSize size, const VulkanBuffer& destination, VkDeviceSize destinationOffset = 0);
+		bool IsComplete(uint64_t upload) const;
+
+		// Reclaims the space of the frame slot, once its in-flight fence signaled
+		void BeginFrame(uint32_t frame);
+		// Records pending copies, outside of a render pass, into a command buffer submitted with the frame's fence
+		void Record(VkCommandBuffer commandBuffer);
+
+		// Bytes copied into a single frame, defaults to the capacity split between the frames in flight
+		inline void SetFrameBudget(VkDeviceSize budget) { m_FrameBudget = budget; }
+		inline VkDeviceSize GetCapacity() const { return m_Capacity; }
+		VkDeviceSize GetPendingBytes() const;
+
+	private:
+		bool CreateStagingRing(VkDeviceSize capacity, uint32_t framesInFlight);
+		void ReleaseStagingRing();
+
+		// Largest contiguous range of at most size bytes, zero when the ring is full
+		VkDeviceSize Allocate(VkDeviceSize size, VkDeviceSize& offset);
+
+		struct PendingUpload {
+			uint64_t Id;
+			const unsigned char* Data;
+			VkDeviceSize Size;
+			VkDeviceSize Copied;
+			VkBuffer Destination;
+			VkDeviceSize DestinationOffset;
+		};
+
+		struct FrameSlot {
+			// Ring head once the frame was recorded, everything before it is free once the frame completed
+			uint64_t Head = 0;
+			// Last upload fully recorded into the frame
+			uint64_t LastUpload = 0;
+		};
+
+		VulkanBuffer m_Buffer;
+		VulkanFlushBatch m_FlushBatch;
+		VkDeviceSize m_Capacity = 0;
+		VkDeviceSize m_FrameBudget = 0;
+
+		// Monotonic byte counters, the ring offset is the counter modulo the capacity
+		uint64_t m_Head = 0;
+		uint64_t m_Tail = 0;
+
+		std::vector<FrameSlot> m_Frames;
+		uint32_t m_CurrentFrame = 0;
+
+		std::deque<PendingUpload> m_Pending;
+		uint64_t m_NextUpload = 1;
+		uint64_t m_RecordedUpload = 0;
+		uint64_t m_CompletedUpload = 0;
+
+		mutable std::mutex m_Mutex;
+	};
+
+}
@@ -7,6 +7,7 @@
 
 #include <core/Logger.h>
 #include <core/Asserts.h>
+#include <core/AllocationTracker.h>
 
 namespace Chopper {
 
@@ -85,6 +86,7 @@ namespace Chopper {
 		swapchainCreateInfo.preTransform = capabilities.currentTransform;
 		swapchainCreateInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
 		swapchainCreateInfo.presentMode = presentMode;
+		m_PresentMode = presentMode;
 		swapchainCreateInfo.clipped = VK_TRUE;
 		swapchainCreateInfo.oldSwapchain = nullptr;
 
@@ -159,7 +161,11 @@ namespace Chopper {
 	}
 
 	bool VulkanSwapchain::RecreateSwapchain(uint32_t width, uint32_t height) {
+		// Runs inside the frame, recreating the images allocates
+		CHOPPER_SUSPEND_NO_ALLOCATION_SCOPE();
+
 		VulkanContext::SetSwapchainRecreating(false);
+		++m_RecreationCount;
 		vkDeviceWaitIdle(VulkanContext::GetDevice()->Logical());
 		DestroySwapchain();
 		return CreateSwapchain(width, height);
@@ -20,6 +20,8 @@ namespace Chopper {
 		const VkSurfaceFormatKHR GetSurfaceFormat() const { return m_SurfaceFormat; }
 		const std::vector<VkImageView>& GetViews() const { return m_SwapchainImageViews; }
 		const uint32_t GetMaxFramesInFlight() const { return m_MaxFramesInFlight; }
+		const VkPresentModeKHR GetPresentMode() const { return m_PresentMode; }
+		const uint32_t GetRecreationCount() const { return m_RecreationCount; }
 
 		void RegenerateFramebuffers();
 
@@ -30,6 +32,8 @@ namespace Chopper {
 
 		VkSurfaceFormatKHR m_SurfaceFormat{};
 		uint8_t m_MaxFramesInFlight = 2;
+		VkPresentModeKHR m_PresentMode = VK_PRESENT_MODE_FIFO_KHR;
+		uint32_t m_RecreationCount = 0;
 
 		VkSwapchainKHR m_Swapchain = VK_NULL_HANDLE;
 
@@ -0,0 +1,440 @@
+#include "VulkanUploadScheduler.h"
+
+#include "VulkanContext.h"
+#include "VulkanImage.h"
+
+#include <core/Logger.h>
+#include <core/Profiler.h>
+
+namespace Chopper {
+
+	static constexpr VkAccessFlags s_BufferReadAccess = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT
+		| VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+	// Covers the texel size of every format copied to images
+	static constexpr VkDeviceSize s_StagingAlignment = 16;
+
+	bool VulkanUploadScheduler::CreateUploadScheduler(VkDeviceSize stagingCapacity) {
+		VkDevice device = VulkanContext::GetDevice()->Logical();
+		VkAllocationCallbacks* allocator = VulkanContext::GetAllocator();
+
+		VkCommandPoolCreateInfo commandPoolCreateInfo{};
+		commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		commandPoolCreateInfo.queueFamilyIndex = VulkanContext::GetDevice()->GetQueueFamilyIndices().TransferFamilyIndex;
+		VK_MSG_CHECK(
+			vkCreateCommandPool(device, &commandPoolCreateInfo, allocator, &m_CommandPool),
+			"Failed to create the upload command pool!"
+		);
+
+		VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo{};
+		semaphoreTypeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		semaphoreTypeCreateInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo{};
+		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+		VK_MSG_CHECK(
+			vkCreateSemaphore(device, &semaphoreCreateInfo, allocator, &m_TimelineSemaphore),
+			"Failed to create the upload timeline semaphore!"
+		);
+		VK_MSG_CHECK(
+			vkCreateSemaphore(device, &semaphoreCreateInfo, allocator, &m_GraphicsSemaphore),
+			"Failed to create the graphics timeline semaphore!"
+		);
+
+		stagingCapacity = (stagingCapacity + s_StagingAlignment - 1) / s_StagingAlignment * s_StagingAlignment;
+		if (!m_StagingBuffer.Create(stagingCapacity, VulkanBufferUsage::Staging)) {
+			CHOPPER_LOG_ERROR("Failed to create the upload staging ring!");
+			return false;
+		}
+		m_StagingCapacity = stagingCapacity;
+		m_StagingHead = 0;
+		m_StagingTail = 0;
+		m_SubmittedStagingHead = 0;
+
+		m_NextValue = 1;
+		m_SubmittedValue = 0;
+		m_FailedValues.clear();
+		m_GraphicsValue = 0;
+
+		CHOPPER_LOG_DEBUG("Vulkan Upload Scheduler created.");
+		return true;
+	}
+
+	void VulkanUploadScheduler::ReleaseUploadScheduler() {
+		if (m_CommandPool == VK_NULL_HANDLE)
+			return;
+
+		VkDevice device = VulkanContext::GetDevice()->Logical();
+		VkAllocationCallbacks* allocator = VulkanContext::GetAllocator();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_Pending.empty())
+			CHOPPER_LOG_WARN("{} uploads were never submitted.", m_Pending.size());
+
+		CHOPPER_LOG_DEBUG("Destroying Vulkan Upload Scheduler...");
+		m_Pending.clear();
+		m_InFlight.clear();
+		m_FreeCommandBuffers.clear();
+		m_BufferAcquires.clear();
+		m_ImageAcquires.clear();
+		m_StagingBuffer.Release();
+		m_StagingCapacity = 0;
+
+		vkDestroySemaphore(device, m_GraphicsSemaphore, allocator);
+		vkDestroySemaphore(device, m_TimelineSemaphore, allocator);
+		vkDestroyCommandPool(device, m_CommandPool, allocator);
+		m_GraphicsSemaphore = VK_NULL_HANDLE;
+		m_TimelineSemaphore = VK_NULL_HANDLE;
+		m_CommandPool = VK_NULL_HANDLE;
+	}
+
+	uint64_t VulkanUploadScheduler::UploadBuffer(const void* data, VkDeviceSize size, const VulkanBuffer& destination, VkDeviceSize destinationOffset, bool inUse) {
+		CHOPPER_ASSERT(size > 0 && destinationOffset + size <= destination.GetSize(), "Buffer upload out of bounds!");
+
+		PendingCopy copy{ VK_NULL_HANDLE, 0, nullptr, destination.GetHandle(), destinationOffset, size, !destination.IsConcurrent(), nullptr, VK_IMAGE_LAYOUT_UNDEFINED, inUse };
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!Stage(data, size, copy)) {
+			CHOPPER_LOG_ERROR("Failed to stage a buffer upload!");
+			return FailedUpload;
+		}
+		m_Pending.push_back(std::move(copy));
+		return m_NextValue;
+	}
+
+	uint64_t VulkanUploadScheduler::UploadImage(const void* data, VkDeviceSize size, VulkanImage& image, VkImageLayout finalLayout, bool inUse) {
+		// Relocations copy on the transfer queue as well and swap the handle underneath the upload
+		CHOPPER_ASSERT(!image.IsRelocatable(), "Relocatable images cannot be streamed!");
+		CHOPPER_ASSERT(size > 0, "Empty image upload!");
+
+		PendingCopy copy{ VK_NULL_HANDLE, 0, nullptr, VK_NULL_HANDLE, 0, size, !image.IsConcurrent(), &image, finalLayout, inUse };
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!Stage(data, size, copy)) {
+			CHOPPER_LOG_ERROR("Failed to stage an image upload!");
+			return FailedUpload;
+		}
+		m_Pending.push_back(std::move(copy));
+		return m_NextValue;
+	}
+
+	bool VulkanUploadScheduler::Stage(const void* data, VkDeviceSize size, PendingCopy& copy) {
+		VkDeviceSize offset = 0;
+		bool allocated = AllocateStaging(size, offset);
+		if (!allocated) {
+			// Batches that completed since the last submit may have freed enough space
+			uint64_t completedValue = 0;
+			vkGetSemaphoreCounterValue(VulkanContext::GetDevice()->Logical(), m_TimelineSemaphore, &completedValue);
+			RetireBatches(completedValue);
+			allocated = AllocateStaging(size, offset);
+		}
+
+		if (allocated) {
+			copy.Source = m_StagingBuffer.GetHandle();
+			copy.SourceOffset = offset;
+			return m_StagingBuffer.Write(data, size, offset, &m_FlushBatch);
+		}
+
+		copy.Overflow = std::make_unique<VulkanBuffer>();
+		if (!copy.Overflow->Create(size, VulkanBufferUsage::Staging) || !copy.Overflow->Write(data, size))
+			return false;
+		copy.Source = copy.Overflow->GetHandle();
+		copy.SourceOffset = 0;
+		return true;
+	}
+
+	bool VulkanUploadScheduler::AllocateStaging(VkDeviceSize size, VkDeviceSize& offset) {
+		if (size > m_StagingCapacity)
+			return false;
+
+		// A copy reads one contiguous range, the end of the ring is skipped when it is too short
+		VkDeviceSize position = m_StagingHead % m_StagingCapacity;
+		VkDeviceSize skipped = position + size > m_StagingCapacity ? m_StagingCapacity - position : 0;
+		if (m_StagingCapacity - (m_StagingHead - m_StagingTail) < skipped + size)
+			return false;
+
+		offset = skipped ? 0 : position;
+		m_StagingHead = (m_StagingHead + skipped + size + s_StagingAlignment - 1) / s_StagingAlignment * s_StagingAlignment;
+		return true;
+	}
+
+	bool VulkanUploadScheduler::IsComplete(uint64_t value) const {
+		if (HasFailed(value))
+			return false;
+
+		uint64_t completedValue = 0;
+		vkGetSemaphoreCounterValue(VulkanContext::GetDevice()->Logical(), m_TimelineSemaphore, &completedValue);
+		return value <= completedValue;
+	}
+
+	bool VulkanUploadScheduler::HasFailed(uint64_t value) const {
+		if (value == FailedUpload)
+			return true;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return std::find(m_FailedValues.begin(), m_FailedValues.end(), value) != m_FailedValues.end();
+	}
+
+	bool VulkanUploadScheduler::Wait(uint64_t value) {
+		CHOPPER_PROFILE_FUNCTION();
+
+		if (HasFailed(value))
+			return false;
+
+		bool pending;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			pending = value > m_SubmittedValue;
+		}
+		if (pending)
+			Submit();
+		if (HasFailed(value))
+			return false;
+
+		VkSemaphoreWaitInfo waitInfo{};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &m_TimelineSemaphore;
+		waitInfo.pValues = &value;
+		return vkWaitSemaphores(VulkanContext::GetDevice()->Logical(), &waitInfo, UINT64_MAX) == VK_SUCCESS;
+	}
+
+	VkCommandBuffer VulkanUploadScheduler::GetCommandBuffer() {
+		if (!m_FreeCommandBuffers.empty()) {
+			VkCommandBuffer commandBuffer = m_FreeCommandBuffers.back();
+			m_FreeCommandBuffers.pop_back();
+			return commandBuffer;
+		}
+
+		VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+		commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		commandBufferAllocateInfo.commandPool = m_CommandPool;
+		commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		commandBufferAllocateInfo.commandBufferCount = 1;
+
+		VkCommandBuffer commandBuffer;
+		VK_MSG_CHECK(
+			vkAllocateCommandBuffers(VulkanContext::GetDevice()->Logical(), &commandBufferAllocateInfo, &commandBuffer),
+			"Failed to allocate an upload command buffer!"
+		);
+		return commandBuffer;
+	}
+
+	void VulkanUploadScheduler::RetireBatches(uint64_t completedValue) {
+		for (size_t i = 0; i < m_InFlight.size();) {
+			if (m_InFlight[i].Value > completedValue) {
+				++i;
+				continue;
+			}
+			m_FreeCommandBuffers.push_back(m_InFlight[i].CommandBuffer);
+			m_StagingTail = std::max(m_StagingTail, m_InFlight[i].StagingHead);
+			m_InFlight[i] = std::move(m_InFlight.back());
+			m_InFlight.pop_back();
+		}
+	}
+
+	void VulkanUploadScheduler::Submit() {
+		CHOPPER_PROFILE_FUNCTION();
+
+		VkDevice device = VulkanContext::GetDevice()->Logical();
+		const PhysicalDeviceQueueFamilyDetails& queueFamilies = VulkanContext::GetDevice()->GetQueueFamilyIndices();
+		bool transferOwnership = queueFamilies.TransferFamilyIndex != queueFamilies.GraphicsFamilyIndex;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		uint64_t completedValue = 0;
+		vkGetSemaphoreCounterValue(device, m_TimelineSemaphore, &completedValue);
+		RetireBatches(completedValue);
+
+		if (m_Pending.empty())
+			return;
+
+		Batch batch{ GetCommandBuffer(), m_NextValue, m_StagingHead, {} };
+
+		// Frames submitted so far may read what is overwritten, the wait covers all earlier graphics work
+		bool waitForGraphics = m_GraphicsValue > 0
+			&& std::any_of(m_Pending.begin(), m_Pending.end(), [](const PendingCopy& copy) { return copy.InUse; });
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		vkBeginCommandBuffer(batch.CommandBuffer, &beginInfo);
+
+		std::vector<VkImageMemoryBarrier> imageBarriers;
+		for (const PendingCopy& copy : m_Pending) {
+			if (!copy.Image)
+				continue;
+
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = copy.Image->GetImage();
+			barrier.subresourceRange = { copy.Image->GetAspectFlags(), 0, copy.Image->GetMipLevels(), 0, 1 };
+			imageBarriers.push_back(barrier);
+		}
+		if (!imageBarriers.empty()) {
+			// Chained to the graphics wait, which lands on the transfer stage
+			vkCmdPipelineBarrier(batch.CommandBuffer, waitForGraphics ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+				0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+			imageBarriers.clear();
+		}
+
+		// Release barriers, the acquire side is the same barrier recorded on the graphics queue
+		std::vector<VkBufferMemoryBarrier> bufferBarriers;
+		size_t bufferAcquireCount = m_BufferAcquires.size();
+		size_t imageAcquireCount = m_ImageAcquires.size();
+		for (PendingCopy& copy : m_Pending) {
+			bool release = transferOwnership && copy.Exclusive;
+
+			if (copy.Image) {
+				VkBufferImageCopy region{};
+				region.imageSubresource = { copy.Image->GetAspectFlags(), 0, 0, 1 };
+				region.imageExtent = { copy.Image->GetWidth(), copy.Image->GetHeight(), 1 };
+				region.bufferOffset = copy.SourceOffset;
+				vkCmdCopyBufferToImage(batch.CommandBuffer, copy.Source, copy.Image->GetImage(),
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+				VkImageMemoryBarrier barrier{};
+				barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				barrier.dstAccessMask = 0;
+				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				barrier.newLayout = copy.FinalLayout;
+				barrier.srcQueueFamilyIndex = release ? queueFamilies.TransferFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
+				barrier.dstQueueFamilyIndex = release ? queueFamilies.GraphicsFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
+				barrier.image = copy.Image->GetImage();
+				barrier.subresourceRange = { copy.Image->GetAspectFlags(), 0, copy.Image->GetMipLevels(), 0, 1 };
+				imageBarriers.push_back(barrier);
+
+				if (release) {
+					barrier.srcAccessMask = 0;
+					barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+					m_ImageAcquires.push_back(barrier);
+				}
+			}
+			else {
+				VkBufferCopy region{};
+				region.srcOffset = copy.SourceOffset;
+				region.dstOffset = copy.Offset;
+				region.size = copy.Size;
+				vkCmdCopyBuffer(batch.CommandBuffer, copy.Source, copy.Buffer, 1, &region);
+
+				// Without a family change the semaphore alone makes the copy visible
+				if (release) {
+					VkBufferMemoryBarrier barrier{};
+					barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+					barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+					barrier.dstAccessMask = 0;
+					barrier.srcQueueFamilyIndex = queueFamilies.TransferFamilyIndex;
+					barrier.dstQueueFamilyIndex = queueFamilies.GraphicsFamilyIndex;
+					barrier.buffer = copy.Buffer;
+					barrier.offset = copy.Offset;
+					barrier.size = copy.Size;
+					bufferBarriers.push_back(barrier);
+
+					barrier.srcAccessMask = 0;
+					barrier.dstAccessMask = s_BufferReadAccess;
+					m_BufferAcquires.push_back(barrier);
+				}
+			}
+
+			if (copy.Overflow)
+				batch.OverflowBuffers.push_back(std::move(copy.Overflow));
+		}
+		if (!bufferBarriers.empty() || !imageBarriers.empty()) {
+			vkCmdPipelineBarrier(batch.CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+				static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(), static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+		}
+		vkEndCommandBuffer(batch.CommandBuffer);
+
+		if (!m_FlushBatch.IsEmpty() && !m_FlushBatch.Flush())
+			CHOPPER_LOG_ERROR("Failed to flush the upload staging ring!");
+
+		VkTimelineSemaphoreSubmitInfo timelineSubmitInfo{};
+		timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineSubmitInfo.signalSemaphoreValueCount = 1;
+		timelineSubmitInfo.pSignalSemaphoreValues = &batch.Value;
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineSubmitInfo;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &batch.CommandBuffer;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &m_TimelineSemaphore;
+
+		VkPipelineStageFlags graphicsWaitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		if (waitForGraphics) {
+			timelineSubmitInfo.waitSemaphoreValueCount = 1;
+			timelineSubmitInfo.pWaitSemaphoreValues = &m_GraphicsValue;
+			submitInfo.waitSemaphoreCount = 1;
+			submitInfo.pWaitSemaphores = &m_GraphicsSemaphore;
+			submitInfo.pWaitDstStageMask = &graphicsWaitStage;
+		}
+
+		VkResult result;
+		{
+			std::lock_guard<std::mutex> queueLock(VulkanContext::GetTransferQueueMutex());
+			result = vkQueueSubmit(VulkanContext::GetDevice()->GetTransferQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+		}
+		// Spent either way, the next batch signals past a failed value
+		++m_NextValue;
+
+		if (result != VK_SUCCESS) {
+			// The value is never signaled, nothing may wait for it. The ring space of the dropped
+			// copies was used by nothing else and the images keep their previous layout.
+			CHOPPER_LOG_ERROR("Failed to submit {} uploads to the transfer queue!", m_Pending.size());
+			m_FailedValues.push_back(batch.Value);
+			m_BufferAcquires.resize(bufferAcquireCount);
+			m_ImageAcquires.resize(imageAcquireCount);
+			m_FreeCommandBuffers.push_back(batch.CommandBuffer);
+			m_StagingHead = m_SubmittedStagingHead;
+			m_Pending.clear();
+			return;
+		}
+
+		for (const PendingCopy& copy : m_Pending) {
+			if (copy.Image)
+				copy.Image->SetLayout(copy.FinalLayout);
+		}
+		m_Pending.clear();
+
+		m_SubmittedStagingHead = m_StagingHead;
+		m_SubmittedValue = batch.Value;
+		m_InFlight.push_back(std::move(batch));
+	}
+
+	uint64_t VulkanUploadScheduler::RecordAcquire(VkCommandBuffer commandBuffer) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (!m_BufferAcquires.empty() || !m_ImageAcquires.empty()) {
+			vkCmdPipelineBarrier(commandBuffer, ConsumerStages, ConsumerStages, 0, 0, nullptr,
+				static_cast<uint32_t>(m_BufferAcquires.size()), m_BufferAcquires.data(),
+				static_cast<uint32_t>(m_ImageAcquires.size()), m_ImageAcquires.data());
+			m_BufferAcquires.clear();
+			m_ImageAcquires.clear();
+		}
+
+		// Waited for by every frame, not only the one acquiring: without a family change the wait
+		// is the only thing ordering the copies before the reads. A signaled value costs nothing.
+		return m_SubmittedValue;
+	}
+
+	uint64_t VulkanUploadScheduler::GetNextGraphicsValue() const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_GraphicsValue + 1;
+	}
+
+	void VulkanUploadScheduler::SetGraphicsSubmitted(uint64_t value) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_GraphicsValue = std::max(m_GraphicsValue, value);
+	}
+
+}
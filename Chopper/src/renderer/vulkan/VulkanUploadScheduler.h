@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include "VulkanBuffer.h"
+
+#include <memory>
+#include <vector>
+#include <mutex>
+
+namespace Chopper {
+
+	class VulkanImage;
+
+	// Copies uploads on the transfer queue so streaming overlaps with rendering. Uploads queued
+	// during a frame are submitted together after its graphics submit and signal the next value of
+	// a timeline semaphore. The following frame acquires the resources, when the families differ,
+	// and every graphics submit waits for the last submitted value.
+	// Exclusive resources are released by the transfer family without being acquired from the
+	// graphics one first, so their previous contents are not carried over.
+	// Data is staged in a persistently mapped ring whose space is reclaimed as batches complete,
+	// uploads that do not fit get a staging buffer of their own.
+	class VulkanUploadScheduler {
+		friend class VulkanContext;
+	public:
+		static constexpr VkDeviceSize DefaultStagingCapacity = 16ull * 1024 * 1024;
+
+		// Returned for uploads that could not be staged
+		static constexpr uint64_t FailedUpload = UINT64_MAX;
+
+		// The data is copied to a staging buffer right away, the destination must stay alive until
+		// the returned value completed. Destinations that frames already submitted may still read
+		// are passed as in use, their batch waits for the last graphics submit before copying.
+		uint64_t UploadBuffer(const void* data, VkDeviceSize size, const VulkanBuffer& destination, VkDeviceSize destinationOffset = 0, bool inUse = false);
+		// Whole first mip level, tightly packed. The image is left in the final layout.
+		uint64_t UploadImage(const void* data, VkDeviceSize size, VulkanImage& image, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, bool inUse = false);
+
+		// Failed uploads never complete
+		bool IsComplete(uint64_t value) const;
+		// The upload could not be staged or its batch failed to submit, the destination was not written
+		bool HasFailed(uint64_t value) const;
+		// Submits the upload when still pending and blocks until it completed, false once it failed
+		bool Wait(uint64_t value);
+		inline VkSemaphore GetTimelineSemaphore() const { return m_TimelineSemaphore; }
+
+		// Submits the uploads queued since the last call to the transfer queue
+		void Submit();
+		// Records the acquire barriers of submitted uploads into the frame's command buffer and
+		// returns the timeline value its graphics submit must wait for, zero before the first upload.
+		// The wait also makes the copies visible to frames recorded without an acquire barrier.
+		uint64_t RecordAcquire(VkCommandBuffer commandBuffer);
+
+		// Timeline signaled by every graphics submit, batches writing resources in use wait on it
+		inline VkSemaphore GetGraphicsSemaphore() const { return m_GraphicsSemaphore; }
+		uint64_t GetNextGraphicsValue() const;
+		// Called once a graphics submit signaling the value succeeded
+		void SetGraphicsSubmitted(uint64_t value);
+
+		// Stages reading the uploaded resources, graphics submits wait on the timeline there
+		static constexpr VkPipelineStageFlags ConsumerStages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+			| VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+	private:
+		bool CreateUploadScheduler(VkDeviceSize stagingCapacity);
+		void ReleaseUploadScheduler();
+
+		struct PendingCopy {
+			VkBuffer Source;
+			VkDeviceSize SourceOffset;
+			// Null when staged in the ring
+			std::unique_ptr<VulkanBuffer> Overflow;
+			VkBuffer Buffer;
+			VkDeviceSize Offset;
+			VkDeviceSize Size;
+			// Needs an ownership transfer when the families differ
+			bool Exclusive;
+			// Null for buffer uploads
+			VulkanImage* Image;
+			VkImageLayout FinalLayout;
+			// Possibly read by submitted frames
+			bool InUse;
+		};
+
+		struct Batch {
+			VkCommandBuffer CommandBuffer;
+			uint64_t Value;
+			// Ring head once the batch was submitted, everything before it is free once it completed
+			uint64_t StagingHead;
+			std::vector<std::unique_ptr<VulkanBuffer>> OverflowBuffers;
+		};
+
+		// Copies the data into the ring, or into a buffer of its own when the ring has no room
+		bool Stage(const void* data, VkDeviceSize size, PendingCopy& copy);
+		bool AllocateStaging(VkDeviceSize size, VkDeviceSize& offset);
+		VkCommandBuffer GetCommandBuffer();
+		void RetireBatches(uint64_t completedValue);
+
+		std::vector<PendingCopy> m_Pending;
+		std::vector<Batch> m_InFlight;
+		std::vector<VkCommandBuffer> m_FreeCommandBuffers;
+
+		// Acquire side of the ownership transfers, recorded by the next frame
+		std::vector<VkBufferMemoryBarrier> m_BufferAcquires;
+		std::vector<VkImageMemoryBarrier> m_ImageAcquires;
+		uint64_t m_SubmittedValue = 0;
+
+		VulkanBuffer m_StagingBuffer;
+		VulkanFlushBatch m_FlushBatch;
+		VkDeviceSize m_StagingCapacity = 0;
+		// Monotonic byte counters, the ring offset is the counter modulo the capacity
+		uint64_t m_StagingHead = 0;
+		uint64_t m_StagingTail = 0;
+		uint64_t m_SubmittedStagingHead = 0;
+
+		VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+		VkSemaphore m_TimelineSemaphore = VK_NULL_HANDLE;
+		// Value signaled by the next submit
+		uint64_t m_NextValue = 1;
+		// Values of batches that failed to submit, later batches signal past them
+		std::vector<uint64_t> m_FailedValues;
+
+		VkSemaphore m_GraphicsSemaphore = VK_NULL_HANDLE;
+		// Signaled by the last submitted graphics work
+		uint64_t m_GraphicsValue = 0;
+
+		mutable std::mutex m_Mutex;
+	};
+
+}
@@ -0,0 +1,243 @@
+#include <core/Event.h>
+#include <core/events/WindowEvent.h>
+#include <core/events/KeyEvent.h>
+#include <core/events/MouseEvent.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+
+using namespace Chopper;
+
+// Every heap allocation made by the process goes through here
+static std::atomic<uint64_t> s_Allocations{ 0 };
+
+void* operator new(size_t size) {
+	s_Allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(size ? size : 1))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+	std::free(memory);
+}
+
+// Keeps the optimizer from dropping the measured work
+static volatile uint64_t s_Sink = 0;
+
+struct Result {
+	double NanosecondsPerEvent;
+	double AllocationsPerEvent;
+};
+
+template<typename F>
+static Result Measure(uint64_t iterations, F&& body) {
+	uint64_t allocations = s_Allocations.load(std::memory_order_relaxed);
+	auto start = std::chrono::steady_clock::now();
+	for (uint64_t i = 0; i < iterations; ++i)
+		body(i);
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	allocations = s_Allocations.load(std::memory_order_relaxed) - allocations;
+
+	Result result;
+	result.NanosecondsPerEvent = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / iterations;
+	result.AllocationsPerEvent = static_cast<double>(allocations) / iterations;
+	return result;
+}
+
+static void Report(const char* name, const Result& result) {
+	std::printf("%-32s %8.2f ns/event %8.3f allocations/event\n", name, result.NanosecondsPerEvent, result.AllocationsPerEvent);
+}
+
+// What the cursor callback does: build the event, copy it as the event queue would and dispatch it
+static Result BenchmarkMouseMoved(uint64_t iterations) {
+	return Measure(iterations, [](uint64_t i) {
+		MouseMovedEvent e{ static_cast<float>(i & 1023), static_cast<float>(i >> 10 & 1023) };
+		MouseMovedEvent queued = e;
+
+		EventDispatcher dispatcher(queued);
+		dispatcher.Dispatch<MouseMovedEvent>([](MouseMovedEvent& e) {
+			s_Sink = s_Sink + static_cast<uint64_t>(e.GetX() + e.GetY());
+			return false;
+		});
+	});
+}
+
+static Result BenchmarkEventNames(uint64_t iterations) {
+	return Measure(iterations, [](uint64_t i) {
+		KeyPressedEvent e{ static_cast<KeyCode>(i & 127), 0 };
+		s_Sink = s_Sink + e.GetName().size() + e.GetCategory();
+	});
+}
+
+// The dispatcher events used before, kept here as the baseline: the type check is a virtual
+// call and every handler is wrapped in a std::function
+namespace Legacy {
+
+	class Event {
+	public:
+		virtual ~Event() = default;
+		virtual EventType GetEventType() const = 0;
+
+		bool Handled = false;
+	};
+
+	template<EventType Type>
+	class TypedEvent : public Event {
+	public:
+		static EventType GetStaticType() { return Type; }
+		EventType GetEventType() const override { return Type; }
+	};
+
+	class WindowCloseEvent : public TypedEvent<EventType::WindowClose> {};
+	class WindowResizeEvent : public TypedEvent<EventType::WindowResize> {};
+	class KeyPressedEvent : public TypedEvent<EventType::KeyPressed> {};
+	class MouseMovedEvent : public TypedEvent<EventType::MouseMoved> {};
+
+	class EventDispatcher {
+		template<typename T>
+		using EventCallback = std::function<bool(T&)>;
+	public:
+		EventDispatcher(Event& e) : m_Event(e) {}
+
+		template<typename T>
+		bool Dispatch(EventCallback<T> func) {
+			if (m_Event.GetEventType() == T::GetStaticType())
+				m_Event.Handled = func(*(T*)&m_Event);
+			return m_Event.Handled;
+		}
+
+	private:
+		Event& m_Event;
+	};
+
+}
+
+static constexpr uint32_t s_EventMix = 64;
+
+// Mostly mouse moves like real input, with a few keys, resizes and one close
+static EventType MixedEventType(uint64_t i) {
+	uint32_t slot = static_cast<uint32_t>(i % s_EventMix);
+	if (slot % 16 == 0)
+		return EventType::KeyPressed;
+	if (slot % 32 == 1)
+		return EventType::WindowResize;
+	if (slot == s_EventMix - 1)
+		return EventType::WindowClose;
+	return EventType::MouseMoved;
+}
+
+// Application::OnEvent's three handlers
+static Result BenchmarkLegacyDispatch(uint64_t iterations) {
+	Legacy::WindowCloseEvent close;
+	Legacy::WindowResizeEvent resize;
+	Legacy::KeyPressedEvent key;
+	Legacy::MouseMovedEvent move;
+	Legacy::Event* events[s_EventMix];
+	for (uint32_t i = 0; i < s_EventMix; ++i) {
+		switch (MixedEventType(i)) {
+			case EventType::WindowClose:  events[i] = &close; break;
+			case EventType::WindowResize: events[i] = &resize; break;
+			case EventType::KeyPressed:   events[i] = &key; break;
+			default:                      events[i] = &move; break;
+		}
+	}
+
+	uint64_t handled = 0;
+	Result result = Measure(iterations, [&](uint64_t i) {
+		Legacy::Event& e = *events[i % s_EventMix];
+		e.Handled = false;
+
+		Legacy::EventDispatcher dispatcher(e);
+		dispatcher.Dispatch<Legacy::WindowCloseEvent>([&](Legacy::WindowCloseEvent&) { ++handled; return true; });
+		dispatcher.Dispatch<Legacy::WindowResizeEvent>([&](Legacy::WindowResizeEvent&) { ++handled; return false; });
+		dispatcher.Dispatch<Legacy::KeyPressedEvent>([&](Legacy::KeyPressedEvent&) { ++handled; return false; });
+	});
+	s_Sink = s_Sink + handled;
+	return result;
+}
+
+// Events are values now, each iteration raises a fresh one of the mixed type
+template<typename D>
+static Result BenchmarkDispatch(uint64_t iterations, D&& dispatch) {
+	uint64_t handled = 0;
+	Result result = Measure(iterations, [&](uint64_t i) {
+		switch (MixedEventType(i)) {
+			case EventType::WindowClose: {
+				WindowCloseEvent e;
+				dispatch(e, handled);
+				break;
+			}
+			case EventType::WindowResize: {
+				WindowResizeEvent e{ 1280, 720 };
+				dispatch(e, handled);
+				break;
+			}
+			case EventType::KeyPressed: {
+				KeyPressedEvent e{ Key::F12, 0 };
+				dispatch(e, handled);
+				break;
+			}
+			default: {
+				MouseMovedEvent e{ 0.0f, 0.0f };
+				dispatch(e, handled);
+				break;
+			}
+		}
+	});
+	s_Sink = s_Sink + handled;
+	return result;
+}
+
+static void DispatchEach(Event& e, uint64_t& handled) {
+	EventDispatcher dispatcher(e);
+	dispatcher.Dispatch<WindowCloseEvent>([&](WindowCloseEvent&) { ++handled; return true; });
+	dispatcher.Dispatch<WindowResizeEvent>([&](WindowResizeEvent&) { ++handled; return false; });
+	dispatcher.Dispatch<KeyPressedEvent>([&](KeyPressedEvent&) { ++handled; return false; });
+}
+
+static void DispatchAll(Event& e, uint64_t& handled) {
+	EventDispatcher dispatcher(e);
+	dispatcher.DispatchAll(
+		[&](WindowCloseEvent&) { ++handled; return true; },
+		[&](WindowResizeEvent&) { ++handled; return false; },
+		[&](KeyPressedEvent&) { ++handled; return false; }
+	);
+}
+
+int main(int argc, char* argv[]) {
+	uint64_t iterations = 10000000;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			iterations = std::strtoull(argv[++i], nullptr, 10);
+	}
+	if (iterations == 0) {
+		std::fprintf(stderr, "Usage: chopper-eventbench [-n iterations]\n");
+		return 1;
+	}
+
+	Result mouseMoved = BenchmarkMouseMoved(iterations);
+	Result eventNames = BenchmarkEventNames(iterations);
+	Report("MouseMoved construct+dispatch", mouseMoved);
+	Report("KeyPressed name+category", eventNames);
+
+	Report("Legacy std::function dispatch", BenchmarkLegacyDispatch(iterations));
+	Report("Dispatch per handler", BenchmarkDispatch(iterations, DispatchEach));
+	Report("DispatchAll", BenchmarkDispatch(iterations, DispatchAll));
+
+	// Nonzero exit when raising an event touched the heap, so the check can run unattended
+	if (mouseMoved.AllocationsPerEvent > 0.0 || eventNames.AllocationsPerEvent > 0.0) {
+		std::fprintf(stderr, "Events allocated on the heap.\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,267 @@
+#include <core/BinaryLogFormat.h>
+
+#include <fmt/format.h>
+#include <fmt/args.h>
+#include <fmt/chrono.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace Chopper;
+
+struct FormatInfo {
+	BinaryLogFormat::Level Level;
+	uint32_t Line;
+	std::string File;
+	std::string Format;
+};
+
+struct DecodedMessage {
+	uint64_t Timestamp;
+	std::string Text;
+};
+
+class Reader {
+public:
+	Reader(std::vector<uint8_t> data) : m_Data(std::move(data)) {}
+
+	template<typename T>
+	bool Read(T& value) {
+		if (m_Offset + sizeof(T) > m_Data.size())
+			return false;
+		std::memcpy(&value, m_Data.data() + m_Offset, sizeof(T));
+		m_Offset += sizeof(T);
+		return true;
+	}
+
+	bool ReadString(std::string& value) {
+		uint16_t length;
+		if (!Read(length) || m_Offset + length > m_Data.size())
+			return false;
+		value.assign(reinterpret_cast<const char*>(m_Data.data() + m_Offset), length);
+		m_Offset += length;
+		return true;
+	}
+
+	bool Skip(size_t size) {
+		if (m_Offset + size > m_Data.size())
+			return false;
+		m_Offset += size;
+		return true;
+	}
+
+	inline bool AtEnd() const { return m_Offset >= m_Data.size(); }
+	inline size_t GetOffset() const { return m_Offset; }
+
+private:
+	std::vector<uint8_t> m_Data;
+	size_t m_Offset = 0;
+};
+
+static const char* LevelName(BinaryLogFormat::Level level) {
+	switch (level) {
+		case BinaryLogFormat::Level::Trace:    return "trace";
+		case BinaryLogFormat::Level::Debug:    return "debug";
+		case BinaryLogFormat::Level::Info:     return "info";
+		case BinaryLogFormat::Level::Warn:     return "warning";
+		case BinaryLogFormat::Level::Error:    return "error";
+		case BinaryLogFormat::Level::Critical: return "critical";
+		default:                               return "unknown";
+	}
+}
+
+static bool ReadArguments(Reader& reader, size_t end, fmt::dynamic_format_arg_store<fmt::format_context>& store) {
+	using Type = BinaryLogFormat::ArgumentType;
+
+	while (reader.GetOffset() < end) {
+		uint8_t tag;
+		if (!reader.Read(tag))
+			return false;
+
+		switch (static_cast<Type>(tag)) {
+			case Type::Int64: {
+				int64_t value;
+				if (!reader.Read(value))
+					return false;
+				store.push_back(value);
+				break;
+			}
+			case Type::UInt64: {
+				uint64_t value;
+				if (!reader.Read(value))
+					return false;
+				store.push_back(value);
+				break;
+			}
+			case Type::Double: {
+				double value;
+				if (!reader.Read(value))
+					return false;
+				store.push_back(value);
+				break;
+			}
+			case Type::Bool: {
+				uint8_t value;
+				if (!reader.Read(value))
+					return false;
+				store.push_back(value != 0);
+				break;
+			}
+			case Type::Char: {
+				char value;
+				if (!reader.Read(value))
+					return false;
+				store.push_back(value);
+				break;
+			}
+			case Type::String: {
+				std::string value;
+				if (!reader.ReadString(value))
+					return false;
+				store.push_back(value);
+				break;
+			}
+			default:
+				return false;
+		}
+	}
+	return reader.GetOffset() == end;
+}
+
+static int Decode(const char* inputPath, FILE* output, bool showSource) {
+	std::ifstream file(inputPath, std::ios::binary);
+	if (!file.is_open()) {
+		fmt::print(stderr, "Could not open {}.\n", inputPath);
+		return 1;
+	}
+	Reader reader(std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {}));
+
+	char magic[sizeof(BinaryLogFormat::Magic)];
+	uint32_t version;
+	uint64_t startWallClock;
+	if (!reader.Read(magic) || std::memcmp(magic, BinaryLogFormat::Magic, sizeof(magic)) != 0
+		|| !reader.Read(version) || version != BinaryLogFormat::Version || !reader.Read(startWallClock)) {
+		fmt::print(stderr, "{} is not a supported binary log.\n", inputPath);
+		return 1;
+	}
+
+	std::unordered_map<uint32_t, FormatInfo> formats;
+	std::vector<DecodedMessage> messages;
+
+	while (!reader.AtEnd()) {
+		uint8_t kind;
+		if (!reader.Read(kind))
+			break;
+
+		if (static_cast<BinaryLogFormat::RecordKind>(kind) == BinaryLogFormat::RecordKind::Format) {
+			uint32_t id;
+			uint8_t level;
+			FormatInfo info;
+			if (!reader.Read(id) || !reader.Read(level) || !reader.Read(info.Line) || !reader.ReadString(info.File) || !reader.ReadString(info.Format)) {
+				fmt::print(stderr, "Truncated format record.\n");
+				return 1;
+			}
+			info.Level = static_cast<BinaryLogFormat::Level>(level);
+			formats[id] = std::move(info);
+			continue;
+		}
+
+		if (static_cast<BinaryLogFormat::RecordKind>(kind) != BinaryLogFormat::RecordKind::Message) {
+			fmt::print(stderr, "Unknown record kind {} at offset {}.\n", kind, reader.GetOffset() - 1);
+			return 1;
+		}
+
+		uint32_t formatId, thread, argumentSize;
+		uint64_t timestamp;
+		if (!reader.Read(formatId) || !reader.Read(timestamp) || !reader.Read(thread) || !reader.Read(argumentSize)) {
+			fmt::print(stderr, "Truncated message record.\n");
+			return 1;
+		}
+
+		size_t end = reader.GetOffset() + argumentSize;
+		auto it = formats.find(formatId);
+		if (it == formats.end()) {
+			fmt::print(stderr, "Message references unknown format {}.\n", formatId);
+			if (!reader.Skip(argumentSize))
+				return 1;
+			continue;
+		}
+
+		fmt::dynamic_format_arg_store<fmt::format_context> arguments;
+		if (!ReadArguments(reader, end, arguments)) {
+			fmt::print(stderr, "Malformed arguments for format {}.\n", formatId);
+			return 1;
+		}
+
+		std::string message;
+		try {
+			message = fmt::vformat(it->second.Format, arguments);
+		}
+		catch (const fmt::format_error& e) {
+			message = fmt::format("{} [format error: {}]", it->second.Format, e.what());
+		}
+
+		auto time = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+			std::chrono::nanoseconds(startWallClock + timestamp)));
+		auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+
+		DecodedMessage decoded;
+		decoded.Timestamp = timestamp;
+		decoded.Text = fmt::format("[{:%m-%d-%y %H:%M:%S}.{:03}] T{} ({}): {}", fmt::localtime(std::chrono::system_clock::to_time_t(time)),
+			milliseconds, thread, LevelName(it->second.Level), message);
+		if (showSource)
+			decoded.Text += fmt::format(" ({}:{})", it->second.File, it->second.Line);
+		messages.push_back(std::move(decoded));
+	}
+
+	// Each thread buffer is written out whole, so file order is only chronological per thread.
+	// Stable so messages with the same timestamp keep their file order.
+	std::stable_sort(messages.begin(), messages.end(), [](const DecodedMessage& a, const DecodedMessage& b) {
+		return a.Timestamp < b.Timestamp;
+	});
+	for (const DecodedMessage& decoded : messages)
+		fmt::print(output, "{}\n", decoded.Text);
+
+	fmt::print(stderr, "Decoded {} messages using {} formats.\n", messages.size(), formats.size());
+	return 0;
+}
+
+int main(int argc, char* argv[]) {
+	const char* inputPath = nullptr;
+	const char* outputPath = nullptr;
+	bool showSource = false;
+
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			outputPath = argv[++i];
+		else if (std::strcmp(argv[i], "--source") == 0)
+			showSource = true;
+		else
+			inputPath = argv[i];
+	}
+
+	if (!inputPath) {
+		fmt::print(stderr, "Usage: chopper-logdecode <file.chbl> [-o output.txt] [--source]\n");
+		return 1;
+	}
+
+	FILE* output = stdout;
+	if (outputPath) {
+		output = std::fopen(outputPath, "w");
+		if (!output) {
+			fmt::print(stderr, "Could not open {} for writing.\n", outputPath);
+			return 1;
+		}
+	}
+
+	int result = Decode(inputPath, output, showSource);
+	if (output != stdout)
+		std::fclose(output);
+	return result;
+}